@@ -0,0 +1,419 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	rhealstone.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Rhealstone benchmark of mariOS. It measures task switch,
+ * 			preemption, interrupt latency, semaphore shuffle, deadlock break
+ * 			and message latency, through both the native API and cmsis_os.h,
+ * 			and prints a report by means of semihosting
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdio.h>
+
+#include "stm32f4xx.h"
+
+#include "cmsis_os.h"
+#include "queue.h"
+#include "notification.h"
+#include "semaphore.h"
+#include "mutex.h"
+
+/**
+ * Number of samples taken by each test.
+ */
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS		1000
+#endif
+
+/**
+ * Frequency of the timestamp timer. TIM2 is used instead of the DWT cycle
+ * counter, which is not emulated by QEMU. It can be overridden whenever the
+ * RCC registers do not tell the actual timer clock.
+ */
+#ifndef BENCH_TIMER_HZ
+#define BENCH_TIMER_HZ			bench_timer_frequency()
+#endif
+
+/**
+ * Interrupt line, unused by the board, that the interrupt latency test pends by software.
+ */
+#define BENCH_IRQn				EXTI1_IRQn
+#define BENCH_IRQHandler		EXTI1_IRQHandler
+
+#define BENCH_HIGH_PRIORITY		3
+#define BENCH_MEDIUM_PRIORITY	2
+#define BENCH_LOW_PRIORITY		1
+#define BENCH_HIGH_STACK		256
+#define BENCH_MEDIUM_STACK		128
+#define BENCH_LOW_STACK			768		/* words, it has to fit printf() */
+#define BENCH_PERIOD			100000	/* ms, long enough not to trigger the hanging CPU check of the scheduler */
+
+/**
+ * Commands the low priority task sends to the high priority one, by means
+ * of its notification word.
+ */
+typedef enum
+{
+	BENCH_CMD_SWITCH = 1,			/**< Record the preemption and go back waiting			*/
+	BENCH_CMD_SEMAPHORE,			/**< Take the native semaphore							*/
+	BENCH_CMD_MUTEX,				/**< Lock the mutex owned by the low priority task		*/
+	BENCH_CMD_MESSAGE,				/**< Dequeue a timestamp from the native queue			*/
+	BENCH_CMD_INTERRUPT,			/**< Record the latency from the interrupt handler		*/
+	BENCH_CMD_CMSIS_SEMAPHORE,		/**< Take the CMSIS semaphore							*/
+	BENCH_CMD_CMSIS_MAIL			/**< Get a timestamp from the CMSIS mail queue			*/
+} bench_command_t;
+
+/**
+ * Samples of a test, in timer ticks.
+ */
+typedef struct
+{
+	const char* name;
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+} bench_result_t;
+
+enum
+{
+	BENCH_TASK_SWITCH,
+	BENCH_PREEMPTION,
+	BENCH_INTERRUPT_LATENCY,
+	BENCH_INTERRUPT_TO_TASK,
+	BENCH_SEMAPHORE_SHUFFLE,
+	BENCH_DEADLOCK_BREAK,
+	BENCH_MESSAGE_LATENCY,
+	BENCH_CMSIS_SEMAPHORE_SHUFFLE,
+	BENCH_CMSIS_MESSAGE_LATENCY,
+	BENCH_RESULTS
+};
+
+static bench_result_t bench_results[BENCH_RESULTS] =
+{
+	[BENCH_TASK_SWITCH]				= { "task switch" },
+	[BENCH_PREEMPTION]				= { "preemption" },
+	[BENCH_INTERRUPT_LATENCY]		= { "interrupt latency" },
+	[BENCH_INTERRUPT_TO_TASK]		= { "interrupt to task" },
+	[BENCH_SEMAPHORE_SHUFFLE]		= { "semaphore shuffle" },
+	[BENCH_DEADLOCK_BREAK]			= { "deadlock break" },
+	[BENCH_MESSAGE_LATENCY]			= { "message latency" },
+	[BENCH_CMSIS_SEMAPHORE_SHUFFLE]	= { "cmsis semaphore shuffle" },
+	[BENCH_CMSIS_MESSAGE_LATENCY]	= { "cmsis message latency" },
+};
+
+mariOS_Task_Define(bench_high, bench_high_stack, BENCH_HIGH_STACK);
+mariOS_Task_Define(bench_medium, bench_medium_stack, BENCH_MEDIUM_STACK);
+mariOS_Task_Define(bench_low, bench_low_stack, BENCH_LOW_STACK);
+
+mariOS_Binary_Semaphore_Define(bench_semaphore, 0);
+mariOS_Mutex_Define(bench_mutex);
+mariOS_Queue_Define(bench_queue, bench_queue_buffer, 4*sizeof(uint32_t));
+
+osSemaphoreDef(bench_cmsis_semaphore);
+osMailQDef(bench_cmsis_mail, 4, uint32_t);
+static osSemaphoreId bench_cmsis_semaphore_id;
+static osMailQId bench_cmsis_mail_id;
+
+static mariOS_task_id_t bench_high_id;
+static mariOS_task_id_t bench_medium_id;
+
+static volatile uint32_t bench_stamp;		/* taken by the low priority task before the operation under test */
+static volatile uint32_t bench_block_stamp;	/* taken by the high priority task before blocking */
+static volatile uint32_t bench_isr_stamp;	/* taken by the interrupt handler */
+static volatile uint8_t bench_done;			/* set by the high priority task once a command completes */
+static uint32_t bench_timer_overhead;		/* ticks of two back to back timestamps */
+
+extern void initialise_monitor_handles(void); /* semihosting support of newlib (rdimon) */
+
+static inline uint32_t bench_now(void)
+{
+	return TIM2->CNT;
+}
+
+/**
+ * The function returns the frequency of TIM2, which runs at twice the APB1
+ * clock whenever the APB1 prescaler is not 1.
+ */
+static uint32_t bench_timer_frequency(void)
+{
+	uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+	if(RCC_CFGR_PPRE1_DIV1 != (RCC->CFGR & RCC_CFGR_PPRE1))
+		pclk1 *= 2;
+	return pclk1;
+}
+
+/**
+ * The function starts TIM2 as a free running 32-bit counter and measures
+ * the cost of taking a timestamp, which is subtracted from every sample.
+ */
+static void bench_timer_init(void)
+{
+	int i;
+	__HAL_RCC_TIM2_CLK_ENABLE();
+	TIM2->PSC = 0;
+	TIM2->ARR = 0xFFFFFFFF;
+	TIM2->EGR = TIM_EGR_UG;
+	TIM2->CR1 = TIM_CR1_CEN;
+
+	bench_timer_overhead = 0xFFFFFFFF;
+	for(i = 0; i < 16; i++)
+	{
+		uint32_t start = bench_now();
+		uint32_t elapsed = bench_now() - start;
+		if(elapsed < bench_timer_overhead)
+			bench_timer_overhead = elapsed;
+	}
+}
+
+static void bench_record(int test, uint32_t start)
+{
+	uint32_t elapsed = bench_now() - start;
+	bench_result_t* result = &bench_results[test];
+	elapsed = (elapsed > bench_timer_overhead) ? elapsed - bench_timer_overhead : 0;
+	if(0 == result->count || elapsed < result->min)
+		result->min = elapsed;
+	if(elapsed > result->max)
+		result->max = elapsed;
+	result->total += elapsed;
+	result->count++;
+}
+
+/**
+ * The function sends a command to the high priority task, which preempts
+ * the caller at once.
+ */
+static void bench_command(bench_command_t command)
+{
+	bench_done = 0;
+	notify_task(bench_high_id, command, MARIOS_NOTIFY_OVERWRITE);
+}
+
+/**
+ * The function waits for the high priority task to complete the command.
+ * It yields, since a task made ready by a queue is not switched to until
+ * the next scheduling point.
+ */
+static void bench_wait_done(void)
+{
+	while(!bench_done)
+		mariOS_task_yield();
+}
+
+void BENCH_IRQHandler(void)
+{
+	uint8_t higher_priority_task_woken = 0;
+	bench_record(BENCH_INTERRUPT_LATENCY, bench_stamp);
+	bench_isr_stamp = bench_now();
+	notify_task_from_isr(bench_high_id, BENCH_CMD_INTERRUPT, MARIOS_NOTIFY_OVERWRITE, &higher_priority_task_woken);
+	mariOS_yield_from_isr(higher_priority_task_woken);
+}
+
+/**
+ * The high priority task serves the commands of the low priority one.
+ * Each iteration starts when a command preempts the low priority task and
+ * ends when the high priority task blocks again, switching back to it.
+ */
+mariOS_Task(bench_high)
+{
+	uint32_t command, stamp;
+	while(1)
+	{
+		bench_block_stamp = bench_now();
+		take_notification(MARIOS_NOTIFY_TAKE_CLEAR, MARIOS_WAIT_FOREVER, &command);
+		switch(command)
+		{
+		case BENCH_CMD_SWITCH:
+			bench_record(BENCH_PREEMPTION, bench_stamp);
+			break;
+		case BENCH_CMD_SEMAPHORE:
+			take_semaphore(&bench_semaphore, MARIOS_WAIT_FOREVER);
+			bench_record(BENCH_SEMAPHORE_SHUFFLE, bench_stamp);
+			break;
+		case BENCH_CMD_MUTEX:
+			notify_task(bench_medium_id, 1, MARIOS_NOTIFY_OVERWRITE); //The medium task is ready while the mutex is contended
+			stamp = bench_now();
+			lock_mutex(&bench_mutex, MARIOS_WAIT_FOREVER);
+			bench_record(BENCH_DEADLOCK_BREAK, stamp);
+			unlock_mutex(&bench_mutex);
+			break;
+		case BENCH_CMD_MESSAGE:
+			dequeue(bench_queue, (uint8_t*)&stamp, sizeof(stamp), MARIOS_BLOCKING_QUEUE_OP);
+			bench_record(BENCH_MESSAGE_LATENCY, stamp);
+			break;
+		case BENCH_CMD_INTERRUPT:
+			bench_record(BENCH_INTERRUPT_TO_TASK, bench_isr_stamp);
+			break;
+		case BENCH_CMD_CMSIS_SEMAPHORE:
+			osSemaphoreWait(bench_cmsis_semaphore_id, osWaitForever);
+			bench_record(BENCH_CMSIS_SEMAPHORE_SHUFFLE, bench_stamp);
+			break;
+		case BENCH_CMD_CMSIS_MAIL:
+		{
+			osEvent event = osMailGet(bench_cmsis_mail_id, osWaitForever);
+			if(osEventMail == event.status)
+			{
+				stamp = *(uint32_t*)event.value.p;
+				osMailFree(bench_cmsis_mail_id, event.value.p);
+				bench_record(BENCH_CMSIS_MESSAGE_LATENCY, stamp);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+		bench_done = 1;
+	}
+}
+
+/**
+ * The medium priority task is woken during the deadlock break test: without
+ * priority inheritance it would run before the mutex owner, inflating the
+ * time the high priority task waits for the mutex.
+ */
+mariOS_Task(bench_medium)
+{
+	uint32_t value;
+	while(1)
+		take_notification(MARIOS_NOTIFY_TAKE_CLEAR, MARIOS_WAIT_FOREVER, &value);
+}
+
+static void bench_print(const bench_result_t* result, uint32_t timer_hz)
+{
+	uint32_t mean = (0 == result->count) ? 0 : (uint32_t)(result->total/result->count);
+	printf("%-24s %8lu %8lu %8lu %10lu\n", result->name, (unsigned long)result->min, (unsigned long)mean,
+		   (unsigned long)result->max, (unsigned long)((uint64_t)mean*1000000000/timer_hz));
+}
+
+/**
+ * The low priority task drives all tests and prints the report. Since the
+ * high priority task is ready as soon as it gets a command, each sample
+ * covers exactly the operation under test.
+ */
+mariOS_Task(bench_low)
+{
+	int i, test;
+	uint32_t* mail;
+
+	for(i = 0; i < BENCH_ITERATIONS; i++) //Preemption, then task switch once the high priority task blocks again
+	{
+		bench_stamp = bench_now();
+		bench_command(BENCH_CMD_SWITCH);
+		bench_record(BENCH_TASK_SWITCH, bench_block_stamp);
+		bench_wait_done();
+	}
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		bench_command(BENCH_CMD_SEMAPHORE); //The high priority task blocks on the semaphore
+		bench_stamp = bench_now();
+		give_semaphore(&bench_semaphore);
+		bench_wait_done();
+	}
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		lock_mutex(&bench_mutex, MARIOS_WAIT_FOREVER);
+		bench_command(BENCH_CMD_MUTEX); //The high priority task blocks on the mutex, raising our priority
+		unlock_mutex(&bench_mutex);
+		bench_wait_done();
+	}
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		bench_command(BENCH_CMD_MESSAGE);
+		uint32_t stamp = bench_now();
+		enqueue(bench_queue, (uint8_t*)&stamp, sizeof(stamp), MARIOS_BLOCKING_QUEUE_OP);
+		bench_wait_done();
+	}
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		bench_done = 0;
+		bench_stamp = bench_now();
+		NVIC_SetPendingIRQ(BENCH_IRQn);
+		bench_wait_done();
+	}
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		bench_command(BENCH_CMD_CMSIS_SEMAPHORE);
+		bench_stamp = bench_now();
+		osSemaphoreRelease(bench_cmsis_semaphore_id);
+		bench_wait_done();
+	}
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		bench_command(BENCH_CMD_CMSIS_MAIL);
+		mail = osMailAlloc(bench_cmsis_mail_id, osWaitForever);
+		*mail = bench_now();
+		osMailPut(bench_cmsis_mail_id, mail);
+		bench_wait_done();
+	}
+
+	/**
+	 * The Rhealstone figure is the reciprocal of the mean of the six classic
+	 * times: task switch, preemption, interrupt latency, semaphore shuffle,
+	 * deadlock break and message latency.
+	 */
+	uint32_t timer_hz = BENCH_TIMER_HZ;
+	const int rhealstone[] = { BENCH_TASK_SWITCH, BENCH_PREEMPTION, BENCH_INTERRUPT_LATENCY,
+							   BENCH_SEMAPHORE_SHUFFLE, BENCH_DEADLOCK_BREAK, BENCH_MESSAGE_LATENCY };
+	uint64_t sum = 0;
+	for(test = 0; test < (int)(sizeof(rhealstone)/sizeof(rhealstone[0])); test++)
+		sum += bench_results[rhealstone[test]].total/bench_results[rhealstone[test]].count;
+
+	printf("mariOS Rhealstone benchmark, %d samples per test, timer at %lu Hz\n", BENCH_ITERATIONS, (unsigned long)timer_hz);
+	printf("%-24s %8s %8s %8s %10s\n", "test", "min", "mean", "max", "mean (ns)");
+	for(test = 0; test < BENCH_RESULTS; test++)
+		bench_print(&bench_results[test], timer_hz);
+	if(0 != sum)
+		printf("Rhealstones per second: %lu\n", (unsigned long)((uint64_t)timer_hz*6/sum));
+	printf("BENCH DONE\n");
+
+	while(1)
+		mariOS_delay(BENCH_PERIOD);
+}
+
+int main(void)
+{
+	HAL_Init();
+	initialise_monitor_handles();
+	bench_timer_init();
+
+	osKernelInitialize();
+	bench_high_id = mariOS_task_init(bench_high, bench_high_stack, BENCH_HIGH_STACK, BENCH_HIGH_PRIORITY, BENCH_PERIOD);
+	bench_medium_id = mariOS_task_init(bench_medium, bench_medium_stack, BENCH_MEDIUM_STACK, BENCH_MEDIUM_PRIORITY, BENCH_PERIOD);
+	mariOS_task_init(bench_low, bench_low_stack, BENCH_LOW_STACK, BENCH_LOW_PRIORITY, BENCH_PERIOD);
+	bench_cmsis_semaphore_id = osSemaphoreCreate(osSemaphore(bench_cmsis_semaphore), 0);
+	bench_cmsis_mail_id = osMailCreate(osMailQ(bench_cmsis_mail), NULL);
+
+	NVIC_SetPriority(PendSV_IRQn, 0xff); /* Lowest possible priority */
+	NVIC_SetPriority(SysTick_IRQn, 0x00); /* Highest possible priority */
+	NVIC_SetPriority(BENCH_IRQn, 0x01);
+	NVIC_EnableIRQ(BENCH_IRQn);
+
+	osKernelStart();
+
+	//The program should never reach this point
+	for(;;);
+}
@@ -47,10 +47,6 @@ int main(void)
 	osThreadCreate(&task4, NULL);
 	osThreadCreate(&task5, NULL);
 
-	queueMsgt1_t2 = createQueue(queuet1_t4_buffer, sizeof(uint32_t)*10);
-	queueMsgt2_t3 = createQueue(queuet2_t3_buffer, sizeof(uint32_t)*10);
-	queueMsgt4_t5 = createQueue(queuet4_t5_buffer, sizeof(uint32_t)*10);
-
 	BSP_LED_Off(LED3);
 
 	NVIC_SetPriority(PendSV_IRQn, 0xff); /* Lowest possible priority */
@@ -51,6 +51,11 @@
  *---------------------------------------------------------------------------*/
  
 #include "mariOS.h"
+#include "mutex.h"
+#include "semaphore.h"
+#include "pool.h"
+#include "mail.h"
+#include "timer.h"
  
 #ifndef _CMSIS_OS_H
 #define _CMSIS_OS_H
@@ -69,7 +74,7 @@
 #define osFeature_Pool         1       ///< Memory Pools:    1=available, 0=not available
 #define osFeature_MailQ        1       ///< Mail Queues:     1=available, 0=not available
 #define osFeature_MessageQ     1       ///< Message Queues:  1=available, 0=not available
-#define osFeature_Signals      8       ///< maximum number of Signal Flags available per thread
+#define osFeature_Signals      31      ///< maximum number of Signal Flags available per thread
 #define osFeature_Semaphore    30      ///< maximum count for \ref osSemaphoreCreate function
 #define osFeature_Wait         1       ///< osWait function: 1=available, 0=not available
 #define osFeature_SysTick      1       ///< osKernelSysTick functions: 1=available, 0=not available
@@ -146,19 +151,19 @@ typedef struct marios_task_id_t *osThreadId;
  
 /// Timer ID identifies the timer (pointer to a timer control block).
 /// \note CAN BE CHANGED: \b os_timer_cb is implementation specific in every CMSIS-RTOS.
-typedef struct os_timer_cb *osTimerId;
+typedef struct software_timer_t *osTimerId;
  
 /// Mutex ID identifies the mutex (pointer to a mutex control block).
 /// \note CAN BE CHANGED: \b os_mutex_cb is implementation specific in every CMSIS-RTOS.
-typedef struct os_mutex_cb *osMutexId;
+typedef struct mutex_t *osMutexId;
  
 /// Semaphore ID identifies the semaphore (pointer to a semaphore control block).
 /// \note CAN BE CHANGED: \b os_semaphore_cb is implementation specific in every CMSIS-RTOS.
-typedef struct os_semaphore_cb *osSemaphoreId;
+typedef struct semaphore_t *osSemaphoreId;
  
 /// Pool ID identifies the memory pool (pointer to a memory pool control block).
 /// \note CAN BE CHANGED: \b os_pool_cb is implementation specific in every CMSIS-RTOS.
-typedef struct os_pool_cb *osPoolId;
+typedef struct pool_t *osPoolId;
  
 /// Message ID identifies the message queue (pointer to a message queue control block).
 /// \note CAN BE CHANGED: \b os_messageQ_cb is implementation specific in every CMSIS-RTOS.
@@ -166,7 +171,7 @@ typedef struct os_messageQ_cb *osMessageQId;
  
 /// Mail ID identifies the mail queue (pointer to a mail queue control block).
 /// \note CAN BE CHANGED: \b os_mailQ_cb is implementation specific in every CMSIS-RTOS.
-typedef struct os_mailQ_cb *osMailQId;
+typedef struct mail_queue_t *osMailQId;
  
  
 /// Thread Definition structure contains startup information of a thread.
@@ -183,18 +188,19 @@ typedef struct os_thread_def  {
 /// \note CAN BE CHANGED: \b os_timer_def is implementation specific in every CMSIS-RTOS.
 typedef struct os_timer_def  {
   os_ptimer                 ptimer;    ///< start address of a timer function
+  mariOS_timer*      control_block;    ///< statically allocated timer control block
 } osTimerDef_t;
  
 /// Mutex Definition structure contains setup information for a mutex.
 /// \note CAN BE CHANGED: \b os_mutex_def is implementation specific in every CMSIS-RTOS.
 typedef struct os_mutex_def  {
-  uint32_t                   dummy;    ///< dummy value.
+  mariOS_mutex*              mutex;    ///< statically allocated mutex control block
 } osMutexDef_t;
  
 /// Semaphore Definition structure contains setup information for a semaphore.
 /// \note CAN BE CHANGED: \b os_semaphore_def is implementation specific in every CMSIS-RTOS.
 typedef struct os_semaphore_def  {
-  uint32_t                   dummy;    ///< dummy value.
+  mariOS_semaphore*      semaphore;    ///< statically allocated semaphore control block
 } osSemaphoreDef_t;
  
 /// Definition structure for memory block allocation.
@@ -203,6 +209,7 @@ typedef struct os_pool_def  {
   uint32_t                 pool_sz;    ///< number of items (elements) in the pool
   uint32_t                 item_sz;    ///< size of an item
   void                       *pool;    ///< pointer to memory for pool
+  mariOS_pool*          control_block;    ///< statically allocated pool control block
 } osPoolDef_t;
  
 /// Definition structure for message queue.
@@ -219,6 +226,8 @@ typedef struct os_mailQ_def  {
   uint32_t                queue_sz;    ///< number of elements in the queue
   uint32_t                 item_sz;    ///< size of an item
   void                       *pool;    ///< memory array for mail
+  uint8_t                   *slots;    ///< memory array for the addresses of mails
+  mariOS_mail_queue*  control_block;    ///< statically allocated mail queue control block
 } osMailQDef_t;
  
 /// Event structure contains detailed information about an event.
@@ -364,8 +373,9 @@ osEvent osWait (uint32_t millisec);
 extern const osTimerDef_t os_timer_def_##name
 #else                            // define the object
 #define osTimerDef(name, function)  \
+static mariOS_timer os_timer_cb_##name; \
 const osTimerDef_t os_timer_def_##name = \
-{ (function) }
+{ (function), &os_timer_cb_##name }
 #endif
  
 /// Access a Timer definition.
@@ -438,7 +448,8 @@ osEvent osSignalWait (int32_t signals, uint32_t millisec);
 extern const osMutexDef_t os_mutex_def_##name
 #else                            // define the object
 #define osMutexDef(name)  \
-const osMutexDef_t os_mutex_def_##name = { 0 }
+static mariOS_mutex os_mutex_cb_##name = MARIOS_MUTEX_INITIALIZER; \
+const osMutexDef_t os_mutex_def_##name = { &os_mutex_cb_##name }
 #endif
  
 /// Access a Mutex definition.
@@ -487,7 +498,8 @@ osStatus osMutexDelete (osMutexId mutex_id);
 extern const osSemaphoreDef_t os_semaphore_def_##name
 #else                            // define the object
 #define osSemaphoreDef(name)  \
-const osSemaphoreDef_t os_semaphore_def_##name = { 0 }
+static mariOS_semaphore os_semaphore_cb_##name; \
+const osSemaphoreDef_t os_semaphore_def_##name = { &os_semaphore_cb_##name }
 #endif
  
 /// Access a Semaphore definition.
@@ -541,8 +553,10 @@ osStatus osSemaphoreDelete (osSemaphoreId semaphore_id);
 extern const osPoolDef_t os_pool_def_##name
 #else                            // define the object
 #define osPoolDef(name, no, type)   \
+static uint32_t os_pool_m_##name[MARIOS_POOL_BUFFER_WORDS(no, sizeof(type))]; \
+static mariOS_pool os_pool_cb_##name; \
 const osPoolDef_t os_pool_def_##name = \
-{ (no), sizeof(type), NULL }
+{ (no), sizeof(type), os_pool_m_##name, &os_pool_cb_##name }
 #endif
  
 /// \brief Access a Memory Pool definition.
@@ -646,8 +660,11 @@ osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec);
 extern const osMailQDef_t os_mailQ_def_##name
 #else                            // define the object
 #define osMailQDef(name, queue_sz, type) \
+static uint32_t os_mailQ_m_##name[MARIOS_POOL_BUFFER_WORDS(queue_sz, sizeof(type))]; \
+static uint8_t os_mailQ_q_##name[MARIOS_MAIL_QUEUE_SLOTS_SIZE(queue_sz)]; \
+static mariOS_mail_queue os_mailQ_cb_##name; \
 const osMailQDef_t os_mailQ_def_##name =  \
-{ (queue_sz), sizeof (type) }
+{ (queue_sz), sizeof (type), os_mailQ_m_##name, os_mailQ_q_##name, &os_mailQ_cb_##name }
 #endif
  
 /// \brief Access a Mail Queue Definition.
@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	event_flags.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS event flags. Each task owns a 32-bit word of
+ * 			event flags that other tasks and interrupt handlers can set, while
+ * 			the task can wait for any or all of them.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef EVENT_FLAGS_H_
+#define EVENT_FLAGS_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This enum lists the possible outcomes of wait_signals.
+ * ::MARIOS_SIGNALS_SUCCESS_OP indicates that the requested flags have been
+ * received, while ::MARIOS_SIGNALS_TIMEOUT_OP indicates that they have not
+ * been set within the timeout (or immediately, if the timeout is 0).
+ */
+typedef enum
+{
+	MARIOS_SIGNALS_SUCCESS_OP,		/**< The requested flags have been received					*/
+	MARIOS_SIGNALS_TIMEOUT_OP		/**< The requested flags have not been set within the timeout	*/
+} mariOS_signals_op_status_t;
+
+/**
+ * @brief The set_task_signals function sets some event flags of a task.
+ * If the task is waiting for its flags and the wait condition is now met,
+ * the task is directly made ready, and it preempts the caller if it has a
+ * higher priority.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [in] signals are the flags to set
+ * @return the flags of the task before the call
+ */
+uint32_t set_task_signals(mariOS_task_id_t task_id, uint32_t signals);
+
+/**
+ * @brief The set_task_signals_from_isr function is the set_task_signals that
+ * can be safely invoked by an interrupt handler. It never calls the
+ * scheduler: if the task made ready has a priority higher than the interrupted
+ * one, higher_priority_task_woken is set to 1, to be passed to
+ * mariOS_yield_from_isr() before returning from the ISR.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [in] signals are the flags to set
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return the flags of the task before the call
+ */
+uint32_t set_task_signals_from_isr(mariOS_task_id_t task_id, uint32_t signals, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The clear_task_signals function clears some event flags of a task.
+ * It can be invoked by interrupt handlers too.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [in] signals are the flags to clear
+ * @return the flags of the task before the call
+ */
+uint32_t clear_task_signals(mariOS_task_id_t task_id, uint32_t signals);
+
+/**
+ * @brief The wait_signals function waits for the event flags of the current
+ * active task.
+ * With ::MARIOS_SIGNALS_WAIT_ANY the wait ends as soon as one of the requested
+ * flags is set (any flag, if signals is 0), while with ::MARIOS_SIGNALS_WAIT_ALL
+ * all of them must be set. The received flags are cleared before returning.
+ *
+ * @param [in] signals are the requested flags
+ * @param [in] mode is either ::MARIOS_SIGNALS_WAIT_ANY or ::MARIOS_SIGNALS_WAIT_ALL
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until the flags are received
+ * @param [out] received are the requested flags that were set; it can be NULL
+ * @return ::MARIOS_SIGNALS_SUCCESS_OP or ::MARIOS_SIGNALS_TIMEOUT_OP
+ */
+mariOS_signals_op_status_t wait_signals(uint32_t signals, mariOS_signals_wait_t mode, uint32_t timeout_ticks, uint32_t* received);
+
+#endif /* EVENT_FLAGS_H_ */
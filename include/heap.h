@@ -0,0 +1,207 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	heap.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS heaps. It contains the definition of
+ * 			a two-level segregated fit (TLSF) allocator, whose operations
+ * 			take constant time, along with the kernel heap behind
+ * 			mariOS_malloc() and mariOS_free()
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * Alignment of the blocks handed out by a heap, which suits any type of
+ * the Cortex-M, double and uint64_t included.
+ */
+#define MARIOS_HEAP_ALIGN			8
+
+/**
+ * Number of second-level lists of each first-level class, as a power of 2.
+ * Each power-of-2 range of sizes is split into 16 lists.
+ */
+#define MARIOS_HEAP_SL_LOG2			4
+#define MARIOS_HEAP_SL_COUNT		(1 << MARIOS_HEAP_SL_LOG2)
+
+/**
+ * Blocks smaller than MARIOS_HEAP_SMALL_BLOCK bytes share the first class,
+ * whose lists are MARIOS_HEAP_ALIGN bytes apart. Larger blocks are classed
+ * by their most significant bit, up to ::MARIOS_CONFIG_HEAP_MAX_BLOCK_LOG2.
+ */
+#define MARIOS_HEAP_FL_SHIFT		(MARIOS_HEAP_SL_LOG2 + 3)
+#define MARIOS_HEAP_SMALL_BLOCK		(1 << MARIOS_HEAP_FL_SHIFT)
+#define MARIOS_HEAP_FL_COUNT		(MARIOS_CONFIG_HEAP_MAX_BLOCK_LOG2 - MARIOS_HEAP_FL_SHIFT + 1)
+
+/**
+ * @brief This enum lists the possible outcomes of heap operations.
+ * ::MARIOS_HEAP_SUCCESS_OP indicates a success operation, while
+ * ::MARIOS_HEAP_INVALID_OP indicates that the block does not belong to the
+ * heap or it has already been freed (a second free is detected as long as
+ * the memory of the block has not been allocated again).
+ */
+typedef enum
+{
+	MARIOS_HEAP_SUCCESS_OP,			/**< Heap operation successfully completes				*/
+	MARIOS_HEAP_INVALID_OP			/**< The block is not allocated from the heap			*/
+} mariOS_heap_op_status_t;
+
+struct heap_block_t;
+
+/**
+ * @brief This struct is used to typedef a mariOS heap.
+ * Free blocks are kept into segregated lists: the first level classes them
+ * by power of 2 and the second level splits each class linearly. Two
+ * bitmaps tell which lists are not empty, so that a block is found with a
+ * couple of bit scans and allocations and frees take constant time.
+ * Adjacent free blocks are merged as soon as a block is freed.
+ */
+typedef struct heap_t
+{
+	uint32_t fl_bitmap;												/** first-level classes with free blocks */
+	uint32_t sl_bitmap[MARIOS_HEAP_FL_COUNT];						/** second-level lists with free blocks */
+	struct heap_block_t* free_lists[MARIOS_HEAP_FL_COUNT][MARIOS_HEAP_SL_COUNT];	/** heads of the free lists */
+
+	uint8_t* start;													/** first byte of the region */
+	uint8_t* end;													/** first byte after the region */
+	uint32_t capacity;												/** bytes that can be allocated when the heap is empty */
+	uint32_t used;													/** bytes currently allocated, rounded to the block sizes */
+	uint32_t peak;													/** maximum number of bytes allocated at the same time */
+	uint32_t free;													/** bytes of the free blocks */
+	uint32_t free_blocks;											/** number of free blocks */
+	uint32_t allocations;											/** blocks currently allocated */
+	uint32_t failures;												/** allocations that found no block */
+
+	struct heap_t* next;											/** next heap searched by mariOS_free() */
+} mariOS_heap;
+
+/**
+ * @brief This struct is a snapshot of the statistics of a heap.
+ * Fragmentation is the share of free memory that cannot be handed out as
+ * a single block: 0 means that all the free memory is contiguous. It is
+ * computed from a block of the list holding the largest free blocks, which
+ * can be up to 1/16 smaller than the largest one, hence it is approximate.
+ */
+typedef struct
+{
+	uint32_t capacity;					/** bytes that can be allocated when the heap is empty */
+	uint32_t used;						/** bytes currently allocated, rounded to the block sizes */
+	uint32_t peak;						/** maximum number of bytes allocated at the same time */
+	uint32_t free;						/** bytes of the free blocks */
+	uint32_t largest_free;				/** largest size that heap_allocate() can hand out at once */
+	uint32_t free_blocks;				/** number of free blocks */
+	uint32_t allocations;				/** blocks currently allocated */
+	uint32_t failures;					/** allocations that found no block */
+	uint8_t fragmentation;				/** percentage of the free memory out of the largest free blocks */
+} mariOS_heap_stats;
+
+/**
+ * @brief The function initializes a heap over a memory region and makes it
+ * known to mariOS_free(). Several heaps can coexist, for instance one into
+ * the core-coupled memory and one into the SRAM: the region of the former
+ * is simply defined into the corresponding linker section.
+ *
+ * @param [out] heap is the heap handler
+ * @param [in] region is the memory managed by the heap
+ * @param [in] size is the size of the region in bytes
+ * @retval None
+ */
+void initHeap(mariOS_heap* heap, void* region, uint32_t size);
+
+/**
+ * @brief The heap_allocate function takes a block of at least size bytes
+ * from a heap in constant time, the smallest list that surely fits the size
+ * being searched. It can be invoked by interrupt handlers.
+ *
+ * @param [in,out] heap is the heap handler
+ * @param [in] size is the size of the block in bytes
+ * @return the address of the block, aligned to ::MARIOS_HEAP_ALIGN, or NULL
+ * 		   if no free block fits the size
+ */
+void* heap_allocate(mariOS_heap* heap, uint32_t size);
+
+/**
+ * @brief The heap_free function returns a block to a heap in constant time,
+ * merging it with the adjacent free blocks. It can be invoked by interrupt
+ * handlers.
+ *
+ * @param [in,out] heap is the heap handler
+ * @param [in] block is the address of a block allocated from the heap
+ * @return ::MARIOS_HEAP_SUCCESS_OP or ::MARIOS_HEAP_INVALID_OP
+ */
+mariOS_heap_op_status_t heap_free(mariOS_heap* heap, void* block);
+
+/**
+ * @brief The function takes a snapshot of the statistics of a heap in
+ * constant time: the counters are kept up to date by every allocation and
+ * free, and the largest free blocks are found through the bitmaps.
+ *
+ * @param [in] heap is the heap handler
+ * @param [out] stats receives the statistics
+ * @retval None
+ */
+void get_heap_stats(mariOS_heap* heap, mariOS_heap_stats* stats);
+
+#if MARIOS_CONFIG_HEAP_SIZE
+/**
+ * The kernel heap, which lies on a static region of ::MARIOS_CONFIG_HEAP_SIZE
+ * bytes and is initialized by mariOS_init().
+ */
+extern mariOS_heap mariOS_kernel_heap;
+
+/**
+ * @brief The function initializes the kernel heap. It is called by mariOS_init().
+ *
+ * @param None
+ * @retval None
+ */
+void mariOS_heap_init(void);
+
+/**
+ * @brief The mariOS_malloc function allocates a block from the kernel heap,
+ * in constant time.
+ *
+ * @param [in] size is the size of the block in bytes
+ * @return the address of the block, or NULL if the kernel heap is exhausted
+ */
+void* mariOS_malloc(uint32_t size);
+#endif
+
+/**
+ * @brief The mariOS_free function returns a block to the heap it has been
+ * allocated from, be it the kernel heap or any heap initialized by initHeap().
+ * A NULL block is ignored.
+ *
+ * @param [in] block is the address of the block
+ * @return ::MARIOS_HEAP_SUCCESS_OP or ::MARIOS_HEAP_INVALID_OP
+ */
+mariOS_heap_op_status_t mariOS_free(void* block);
+
+#endif /* HEAP_H_ */
@@ -0,0 +1,88 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	histogram.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS histograms. A histogram counts samples into
+ * 			log2-scale buckets, hence it covers values from a few cycles up to
+ * 			seconds with a fixed and small amount of memory.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <mariOS_config.h>
+#include <inttypes.h>
+
+/**
+ * @brief This struct is used to typedef the mariOS histogram.
+ * Bucket 0 counts the samples equal to 0, while bucket i counts the samples
+ * in [2^(i-1), 2^i); the last bucket also counts every larger sample.
+ */
+typedef struct histogram_t
+{
+	uint32_t buckets[MARIOS_CONFIG_HISTOGRAM_BUCKETS];	/** number of samples of each bucket */
+	uint32_t count;										/** number of samples */
+	uint32_t max;										/** largest sample */
+} mariOS_histogram;
+
+/**
+ * @brief The function adds a sample to a histogram in constant time.
+ *
+ * @param [in,out] histogram is the histogram handler
+ * @param [in] value is the sample
+ * @retval None
+ */
+void histogram_record(mariOS_histogram* histogram, uint32_t value);
+
+/**
+ * @brief The function clears a histogram.
+ *
+ * @param [out] histogram is the histogram handler
+ * @retval None
+ */
+void reset_histogram(mariOS_histogram* histogram);
+
+/**
+ * @brief The function returns the smallest sample counted by a bucket.
+ *
+ * @param [in] bucket is the index of the bucket
+ * @return the lower bound of the bucket
+ */
+uint32_t get_histogram_bucket_bound(uint8_t bucket);
+
+/**
+ * @brief The function returns the smallest value that is greater than or
+ * equal to a given fraction of the samples, rounded up to the bound of the
+ * next bucket (e.g., permille equal to 990 estimates the 99th percentile).
+ *
+ * @param [in] histogram is the histogram handler
+ * @param [in] permille is the fraction of samples, from 0 to 1000
+ * @return the estimated percentile, 0 if the histogram is empty
+ */
+uint32_t get_histogram_percentile(mariOS_histogram* histogram, uint16_t permille);
+
+#endif /* HISTOGRAM_H_ */
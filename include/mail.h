@@ -0,0 +1,193 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	mail.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS mail queues. A mail queue couples a memory pool
+ * 			with a queue of pointers: the sender fills a block of the pool and only
+ * 			its address is queued, hence mails of any size are passed in constant
+ * 			time, without being copied.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef MAIL_H_
+#define MAIL_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+#include "queue.h"
+#include "pool.h"
+#include "semaphore.h"
+
+/**
+ * @brief This enum lists the possible outcomes of mail queue operations.
+ * ::MARIOS_MAIL_SUCCESS_OP indicates a success operation
+ * ::MARIOS_MAIL_TIMEOUT_OP indicates that no block or mail has been obtained
+ * within the timeout (or immediately, if the timeout is 0), while
+ * ::MARIOS_MAIL_INVALID_OP indicates that the mail does not belong to the
+ * mail queue.
+ */
+typedef enum
+{
+	MARIOS_MAIL_SUCCESS_OP,			/**< Mail operation successfully completes					*/
+	MARIOS_MAIL_TIMEOUT_OP,			/**< No block or mail has been obtained within the timeout	*/
+	MARIOS_MAIL_INVALID_OP			/**< The mail does not belong to the mail queue				*/
+} mariOS_mail_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS mail queue.
+ * The queue has a slot for the address of each block of the pool, hence
+ * putting a mail never fails: tasks only wait for a free block, counted by
+ * free_blocks, or for a mail, counted by mails.
+ */
+typedef struct mail_queue_t
+{
+	mariOS_pool pool;						/** blocks holding the mails */
+	mariOS_queue queue;						/** addresses of the mails that have been put */
+	mariOS_semaphore free_blocks;			/** number of blocks that can be allocated */
+	mariOS_semaphore mails;					/** number of mails that can be got */
+} mariOS_mail_queue;
+
+/**
+ * This macro returns the number of bytes of the slots of a mail queue.
+ */
+#define MARIOS_MAIL_QUEUE_SLOTS_SIZE(mail_count) ((mail_count) * sizeof(void*))
+
+/**
+ * This macro expands to the compile-time initializer of a ::mariOS_mail_queue.
+ */
+#define MARIOS_MAIL_QUEUE_INITIALIZER(blocks, slots, size, count) { MARIOS_POOL_INITIALIZER(blocks, size, count),\
+																	MARIOS_QUEUE_INITIALIZER(slots, MARIOS_MAIL_QUEUE_SLOTS_SIZE(count), MARIOS_QUEUE_STREAM_MODE),\
+																	MARIOS_SEMAPHORE_INITIALIZER(count, count),\
+																	MARIOS_SEMAPHORE_INITIALIZER(0, count) }
+
+/**
+ * This macro simplifies operations to define a mariOS mail queue of
+ * mail_count mails of size bytes, which is statically allocated along with
+ * its blocks and slots.
+ */
+#define mariOS_Mail_Queue_Define(mail_queue_name, mail_count, size) static uint32_t mail_queue_name##_blocks[MARIOS_POOL_BUFFER_WORDS(mail_count, size)]; \
+																	static uint8_t mail_queue_name##_slots[MARIOS_MAIL_QUEUE_SLOTS_SIZE(mail_count)]; \
+																	static mariOS_mail_queue mail_queue_name = \
+																	MARIOS_MAIL_QUEUE_INITIALIZER(mail_queue_name##_blocks, mail_queue_name##_slots, size, mail_count)
+
+/**
+ * @brief The function initializes a mail queue.
+ *
+ * @param [out] mail_queue is the mail queue handler
+ * @param [in] blocks is the memory of the mails, MARIOS_POOL_BUFFER_WORDS(mail_count, mail_size) words long
+ * @param [in] slots is the memory of the queue, MARIOS_MAIL_QUEUE_SLOTS_SIZE(mail_count) bytes long
+ * @param [in] mail_size is the size of a mail in bytes
+ * @param [in] mail_count is the maximum number of mails
+ * @retval None
+ */
+void initMailQueue(mariOS_mail_queue* mail_queue, uint32_t* blocks, uint8_t* slots, uint32_t mail_size, uint32_t mail_count);
+
+/**
+ * @brief The allocate_mail function allocates a block to be filled with a
+ * mail, waiting for a free block for timeout_ticks at most. It can be invoked
+ * by interrupt handlers with a timeout equal to 0.
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until a block is freed
+ * @return the address of the mail, or NULL if the timeout expired
+ */
+void* allocate_mail(mariOS_mail_queue* mail_queue, uint32_t timeout_ticks);
+
+/**
+ * @brief The allocate_zeroed_mail function is the allocate_mail that also
+ * sets the content of the mail to zero.
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] timeout_ticks is the maximum number of ticks to wait
+ * @return the address of the mail, or NULL if the timeout expired
+ */
+void* allocate_zeroed_mail(mariOS_mail_queue* mail_queue, uint32_t timeout_ticks);
+
+/**
+ * @brief The put_mail function puts a mail allocated by allocate_mail into
+ * the mail queue. It never waits, and it makes ready the task with the
+ * highest priority waiting for a mail, which preempts the caller if it has a
+ * higher priority.
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] mail is the address of the mail
+ * @return ::MARIOS_MAIL_SUCCESS_OP or ::MARIOS_MAIL_INVALID_OP
+ */
+mariOS_mail_op_status_t put_mail(mariOS_mail_queue* mail_queue, void* mail);
+
+/**
+ * @brief The put_mail_from_isr function is the put_mail that can be safely
+ * invoked by an interrupt handler. It never calls the scheduler: if the task
+ * made ready has a priority higher than the interrupted one,
+ * higher_priority_task_woken is set to 1, to be passed to
+ * mariOS_yield_from_isr() before returning from the ISR.
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] mail is the address of the mail
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return ::MARIOS_MAIL_SUCCESS_OP or ::MARIOS_MAIL_INVALID_OP
+ */
+mariOS_mail_op_status_t put_mail_from_isr(mariOS_mail_queue* mail_queue, void* mail, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The get_mail function gets the oldest mail of the mail queue,
+ * waiting for timeout_ticks at most. The mail must be released by free_mail
+ * once it has been consumed. It can be invoked by interrupt handlers with a
+ * timeout equal to 0.
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until a mail is put
+ * @param [out] mail is the address of the mail, NULL if the timeout expired
+ * @return ::MARIOS_MAIL_SUCCESS_OP or ::MARIOS_MAIL_TIMEOUT_OP
+ */
+mariOS_mail_op_status_t get_mail(mariOS_mail_queue* mail_queue, uint32_t timeout_ticks, void** mail);
+
+/**
+ * @brief The free_mail function returns a mail to the pool of the mail
+ * queue, making ready the task with the highest priority waiting for a block.
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] mail is the address of the mail
+ * @return ::MARIOS_MAIL_SUCCESS_OP or ::MARIOS_MAIL_INVALID_OP
+ */
+mariOS_mail_op_status_t free_mail(mariOS_mail_queue* mail_queue, void* mail);
+
+/**
+ * @brief The free_mail_from_isr function is the free_mail that can be safely
+ * invoked by an interrupt handler (see put_mail_from_isr).
+ *
+ * @param [in,out] mail_queue is the mail queue handler
+ * @param [in] mail is the address of the mail
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return ::MARIOS_MAIL_SUCCESS_OP or ::MARIOS_MAIL_INVALID_OP
+ */
+mariOS_mail_op_status_t free_mail_from_isr(mariOS_mail_queue* mail_queue, void* mail, uint8_t* higher_priority_task_woken);
+
+#endif /* MAIL_H_ */
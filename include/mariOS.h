@@ -36,9 +36,10 @@
 
 #include <mariOS_config.h>
 #include "port.h"
+#include "trace.h"
+#include "histogram.h"
 
 #include <string.h> //memcpy
-#include <stdlib.h> //malloc
 
 /**
  * mariOS defines the stack as a long word 64-bits long.
@@ -60,6 +61,30 @@ typedef uint16_t mariOS_task_id_t;
  */
 typedef uint8_t mariOS_priority;
 
+/**
+ * This value marks the absence of a task, e.g. a free mutex has no owner.
+ */
+#define MARIOS_INVALID_TASK_ID		((mariOS_task_id_t)-1)
+
+/**
+ * Timeout value that makes a blocking kernel call wait forever.
+ */
+#define MARIOS_WAIT_FOREVER			0xFFFFFFFF
+
+/**
+ * This macro converts milliseconds into mariOS ticks, leaving
+ * ::MARIOS_WAIT_FOREVER unchanged.
+ */
+#define MARIOS_MS_TO_TICKS(millisec) ((MARIOS_WAIT_FOREVER == (millisec)) ? MARIOS_WAIT_FOREVER :\
+									  (uint32_t)(((uint64_t)MARIOS_CONFIG_SYSTICK_FREQ_DIV*(millisec))/1000))
+
+/**
+ * This macro compares two 32-bit tick counts in a wrap-safe way: it is true
+ * once now has reached deadline, provided that they are less than 2^31
+ * ticks apart.
+ */
+#define MARIOS_TICKS_REACHED(now, deadline)	((int32_t)((uint32_t)(now) - (uint32_t)(deadline)) >= 0)
+
 /**
  * This macro simplifies operations to define a mariOS task.
  * It manages the definition of the task handler and its own stack.
@@ -70,16 +95,32 @@ typedef uint8_t mariOS_priority;
 /**
  * This macro simplifies operations to define a mariOS Queue.
  * It manages the definition of a communication queue and its own memory buffer.
+ * Both the buffer and the control block are statically allocated and the
+ * control block is initialized at compile time, hence no createQueue() call
+ * is needed: queue_name is ready to be used as a ::mariOS_queue pointer.
  */
-#define mariOS_Queue_Define(queue_name, queue_buffer, size) static mariOS_queue* queue_name;\
-													   static uint8_t queue_buffer[size];
+#define mariOS_Queue_Define(queue_name, queue_buffer, size) static uint8_t queue_buffer[size];\
+													   static mariOS_queue queue_name##_control_block = MARIOS_QUEUE_INITIALIZER(queue_buffer, size, MARIOS_QUEUE_STREAM_MODE);\
+													   static mariOS_queue* const queue_name = &queue_name##_control_block
+
+/**
+ * This macro is the same as mariOS_Queue_Define, but it defines a framed
+ * queue (see createFramedQueue()).
+ */
+#define mariOS_Framed_Queue_Define(queue_name, queue_buffer, size) static uint8_t queue_buffer[size];\
+													   static mariOS_queue queue_name##_control_block = MARIOS_QUEUE_INITIALIZER(queue_buffer, size, MARIOS_QUEUE_FRAMED_MODE);\
+													   static mariOS_queue* const queue_name = &queue_name##_control_block
 /**
  * There two following macros can be suitably used during the task definition.
  * The programmer needs to include the task periodic code between such two macros.
+ * Each iteration is a job: jobs are released every period, starting from the
+ * task creation, hence the releases do not drift with the job duration.
+ * The execution time of each job is recorded, and a job completed after the
+ * next release is handled by the overrun policy of the task.
  */
 #define mariOS_begin_periodic do{
 
-#define mariOS_end_periodic mariOS_active_after(get_current_task_period());\
+#define mariOS_end_periodic mariOS_wait_next_release();\
 							}while (1)
 /**
  * This macro simplifies operations to implement a mariOS task.
@@ -115,6 +156,118 @@ typedef enum
 	MARIOS_TASK_STATUS_SUSPEND = 2	/**< Task invoked yield because a resource is busy or it does not exist yet	*/
 } mariOS_task_status_t;
 
+/**
+ * The mariOS_timeout_status_t is the enumerative type that tracks the timeout
+ * of a task suspended by mariOS_suspend_current_task().
+ */
+typedef enum
+{
+	MARIOS_TIMEOUT_NONE = 0,		/**< The task is not waiting with a timeout							*/
+	MARIOS_TIMEOUT_ARMED = 1,		/**< The systick will make the task ready once wait_ticks is reached	*/
+	MARIOS_TIMEOUT_EXPIRED = 2		/**< The task has been made ready by the systick					*/
+} mariOS_timeout_status_t;
+
+/**
+ * The mariOS_signals_wait_t is the enumerative type that tells whether a task
+ * is waiting for its event flags (see event_flags.h) and how they must be
+ * matched to resume it.
+ */
+typedef enum
+{
+	MARIOS_SIGNALS_NOT_WAITING = 0,	/**< The task is not waiting for event flags					*/
+	MARIOS_SIGNALS_WAIT_ANY = 1,	/**< The task waits until any of the requested flags is set		*/
+	MARIOS_SIGNALS_WAIT_ALL = 2		/**< The task waits until all of the requested flags are set	*/
+} mariOS_signals_wait_t;
+
+/**
+ * The mariOS_notify_state_t is the enumerative type that tracks the
+ * notification word of a task (see notification.h).
+ */
+typedef enum
+{
+	MARIOS_NOTIFY_NONE = 0,			/**< No notification is pending									*/
+	MARIOS_NOTIFY_PENDING = 1,		/**< A notification has been received and not yet taken			*/
+	MARIOS_NOTIFY_WAITING = 2		/**< The task is suspended waiting for a notification			*/
+} mariOS_notify_state_t;
+
+/**
+ * The mariOS_overrun_policy_t is the enumerative type that selects how a
+ * periodic task recovers from a job completed after the release of the
+ * next one (see set_task_overrun_policy()).
+ */
+typedef enum
+{
+	MARIOS_OVERRUN_CATCH_UP = 0,	/**< Late jobs run back to back until the task is on time again	*/
+	MARIOS_OVERRUN_SKIP = 1,		/**< Releases already elapsed are dropped						*/
+	MARIOS_OVERRUN_HOOK = 2			/**< The overrun hook of the task decides between the two above	*/
+} mariOS_overrun_policy_t;
+
+/**
+ * The overrun hook of a task takes its ID and the number of ticks the job
+ * completed after its deadline, and returns either ::MARIOS_OVERRUN_CATCH_UP
+ * or ::MARIOS_OVERRUN_SKIP. It runs in the context of the late task.
+ */
+typedef mariOS_overrun_policy_t (*mariOS_overrun_hook_t)(mariOS_task_id_t task_id, uint32_t overrun_ticks);
+
+/**
+ * @brief This struct collects the execution times of the jobs of a periodic
+ * task, in CPU cycles. They are the cycles the task actually executed from
+ * the release of a job to its completion, interrupt handlers included, so
+ * that the maximum is an observed WCET.
+ */
+typedef struct
+{
+	uint32_t jobs;										/** jobs completed */
+	uint32_t min_cycles;								/** shortest job */
+	uint32_t max_cycles;								/** longest job */
+	uint64_t total_cycles;								/** sum of all jobs, to compute the mean */
+} mariOS_execution_stats;
+
+/**
+ * @brief This struct is a list of tasks suspended upon a kernel object,
+ * ordered by decreasing priority (tasks with the same priority are kept in
+ * FIFO order). Tasks are linked through their control blocks, hence the
+ * list does not need any storage but its head.
+ */
+typedef struct wait_list_t
+{
+	volatile mariOS_task_id_t head;		/** the waiting task with the highest priority */
+} mariOS_wait_list;
+
+/**
+ * This macro expands to the compile-time initializer of an empty ::mariOS_wait_list.
+ */
+#define MARIOS_WAIT_LIST_INITIALIZER { MARIOS_INVALID_TASK_ID }
+
+/**
+ * Number of 32-bit words of a ::mariOS_task_set.
+ */
+#define MARIOS_TASK_SET_WORDS		((MARIOS_CONFIG_MAX_TASKS + 31) / 32)
+
+/**
+ * @brief This struct is an unordered set of tasks, one bit per task, used by
+ * kernel objects that wake all their waiters at once. Task i is the bit
+ * 31-(i%32) of the word i/32, so that counting the leading zeros of a word
+ * gives its lowest task ID in a single instruction.
+ */
+typedef struct task_set_t
+{
+	uint32_t words[MARIOS_TASK_SET_WORDS];	/** bits of the tasks into the set */
+} mariOS_task_set;
+
+/**
+ * This macro expands to the compile-time initializer of an empty ::mariOS_task_set.
+ */
+#define MARIOS_TASK_SET_INITIALIZER { {0} }
+
+/**
+ * These macros add a task to a ::mariOS_task_set and test whether it belongs to it.
+ */
+#define mariOS_task_set_add(set, task_id)		((set)->words[(task_id) >> 5] |= 0x80000000U >> ((task_id) & 31))
+#define mariOS_task_set_contains(set, task_id)	(0 != ((set)->words[(task_id) >> 5] & (0x80000000U >> ((task_id) & 31))))
+
+struct mutex_t;
+
 /**
  * @brief This struct defines the mariOS task control block.
  * It contains the task stack pointer, the function pointer to the task
@@ -123,6 +276,10 @@ typedef enum
  * reach to switch its status from ::MARIOS_TASK_STATUS_WAIT to
  * ::MARIOS_TASK_STATUS_READY.
  *
+ * Fields read by the scheduler and the systick come first, packed into the
+ * first words, and enumerations are stored as bytes. Statistics are kept
+ * apart, into ::mariOS_task_statistics_block_t.
+ *
  * @param  None
  * @retval None
  */
@@ -133,15 +290,54 @@ typedef struct
 	   to locate it safely from assembly implementation of PendSV_Handler()).
 	   The compiler might add padding between other structure elements. */
 	volatile uint32_t sp;
-	void (*handler)(void);
-	volatile mariOS_task_status_t status;
-	volatile uint32_t last_active_time;
-	volatile uint32_t last_activation_time;
-	volatile uint32_t wait_ticks;
-	volatile mariOS_priority priority;
+	volatile int8_t status;								/* ::mariOS_task_status_t */
+	volatile mariOS_priority priority;					/* effective priority, it can be raised by priority inheritance */
+	volatile uint8_t timeout;							/* ::mariOS_timeout_status_t of the current suspension */
+	mariOS_priority base_priority;						/* priority assigned to the task */
+	volatile uint64_t wait_ticks;						/* tick that ends the current wait or timeout */
 	volatile uint32_t period;
+	volatile uint32_t last_activation_time;
+	volatile uint32_t last_active_time;
+	volatile mariOS_task_id_t next_waiter;				/* next task into the same wait list */
+	volatile uint8_t signals_wait;						/* ::mariOS_signals_wait_t, how the task is waiting for its event flags */
+	volatile uint8_t notify_state;						/* ::mariOS_notify_state_t of the notification word */
+	mariOS_wait_list* volatile wait_list;				/* wait list the task is suspended upon, if any */
+	struct mutex_t* volatile blocked_mutex;				/* mutex the task is waiting for, if any */
+	struct mutex_t* held_mutexes;						/* list of mutexes owned by the task */
+	volatile uint32_t signals;							/* event flags of the task */
+	volatile uint32_t signals_wait_mask;				/* event flags the task is waiting for */
+	volatile uint32_t notify_value;						/* notification word of the task */
+	volatile uint32_t release_tick;						/* tick of the release of the current job */
+	uint8_t overrun_policy;								/* ::mariOS_overrun_policy_t, how the task recovers from an overrun */
+	mariOS_overrun_hook_t overrun_hook;					/* hook of ::MARIOS_OVERRUN_HOOK */
+	void (*handler)(void);
 } mariOS_task_control_block_t;
 
+/**
+ * @brief This struct collects the statistics of a task. They are only
+ * updated at context switches and job boundaries, hence they are kept
+ * out of the task control block.
+ */
+typedef struct
+{
+	uint32_t run_cycles;								/* cycles executed in the current statistics window */
+	uint32_t job_cycles;								/* cycles executed by the current job */
+	uint32_t release_cycles;							/* cycle counter at the release of the current job */
+	uint32_t voluntary_switches;						/* switches due to the task waiting or suspending */
+	uint32_t preemptions;								/* switches due to a task with higher priority */
+	uint32_t queue_blocks;								/* times the task blocked on a queue */
+	uint32_t deadline_misses;							/* jobs completed after their deadline */
+	uint32_t skipped_releases;							/* releases dropped by ::MARIOS_OVERRUN_SKIP */
+	mariOS_execution_stats execution;					/* execution times of the completed jobs */
+	uint32_t window_cycles[MARIOS_CONFIG_STATS_WINDOWS];	/* cycles executed in the last windows */
+	mariOS_stack_t* stack_base;							/* lowest address of the stack */
+	uint32_t stack_size;								/* size of the stack in words */
+#if MARIOS_CONFIG_TASK_HISTOGRAMS
+	mariOS_histogram wakeup_latency;					/* cycles from the release to the task running again */
+	mariOS_histogram response_time;						/* cycles from the release to the completion of each job */
+#endif
+} mariOS_task_statistics_block_t;
+
 /**
  * @brief This function initialize the mariOS_tasks_list struct and populate it
  * with the first task of the system, namely the idle one.
@@ -247,6 +443,110 @@ void mariOS_task_yield(void);
  */
 void mariOS_delay(uint32_t ticks);
 
+/**
+ * @brief This function sets the current active task to ::MARIOS_TASK_STATUS_WAIT
+ * for the given number of ticks.
+ *
+ * @param [in] ticks is the number of ticks to wait
+ * @retval None
+ */
+void mariOS_active_after(uint32_t ticks);
+
+/**
+ * @brief This function makes the current active task wait until an absolute
+ * time, expressed as by get_time_cycles(). The task sleeps through the
+ * whole ticks that end ::MARIOS_CONFIG_DELAY_SPIN_CYCLES before the deadline
+ * at least, then it spins on the system timer for the remaining cycles.
+ * The spin can be preempted, and the resulting error is returned.
+ *
+ * @param [in] deadline is the time to wait for, in cycles of the systick clock
+ * @return the cycles the function returned after the deadline, negative if before
+ */
+int32_t mariOS_delay_until(uint64_t deadline);
+
+/**
+ * @brief This function makes the current active task wait for the given
+ * microseconds, with the resolution of the system timer rather than of the
+ * tick (see mariOS_delay_until()).
+ *
+ * @param [in] microsec is the number of microseconds to wait
+ * @return the cycles the function returned after the requested time, negative if before
+ */
+int32_t mariOS_delay_us(uint32_t microsec);
+
+/**
+ * @brief This function completes the current job of a periodic task (see
+ * mariOS_end_periodic): it accounts for its execution time, its response
+ * time and its deadline, which is the release of the next job, and then
+ * waits for the next release. If the next job is already released, the
+ * overrun policy of the task is applied: the function either waits for the
+ * first release still to come or returns at once.
+ * A task whose period is 0 has no deadlines: its jobs are released back to
+ * back and never counted as missed.
+ *
+ * @param  None
+ * @retval None
+ */
+void mariOS_wait_next_release(void);
+
+/**
+ * @brief This function returns the number of jobs of a task completed after
+ * their deadline.
+ *
+ * @param [in] task_id is the ID of the task
+ * @return the number of deadline misses
+ */
+uint32_t get_task_deadline_misses(mariOS_task_id_t task_id);
+
+/**
+ * @brief This function sets how a periodic task recovers from an overrun.
+ * By default, the releases already elapsed are dropped (::MARIOS_OVERRUN_SKIP),
+ * so that a runaway job costs the system at most one period. With
+ * ::MARIOS_OVERRUN_CATCH_UP the releases never move instead: late jobs run
+ * back to back, starving lower priority tasks until the task is on time again.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [in] policy is the overrun policy
+ * @param [in] hook is called upon each overrun if policy is ::MARIOS_OVERRUN_HOOK;
+ * 			   if it is NULL, the elapsed releases are dropped
+ * @retval None
+ */
+void set_task_overrun_policy(mariOS_task_id_t task_id, mariOS_overrun_policy_t policy, mariOS_overrun_hook_t hook);
+
+/**
+ * @brief This function returns the number of releases of a task dropped by
+ * ::MARIOS_OVERRUN_SKIP.
+ *
+ * @param [in] task_id is the ID of the task
+ * @return the number of skipped releases
+ */
+uint32_t get_task_skipped_releases(mariOS_task_id_t task_id);
+
+/**
+ * @brief This function copies, in a consistent way, the execution times of the
+ * jobs of a periodic task.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [out] stats receives the execution times; it can be NULL
+ * @return the mean execution time in cycles, or 0 if no job completed yet
+ */
+uint32_t get_task_execution_stats(mariOS_task_id_t task_id, mariOS_execution_stats* stats);
+
+#if MARIOS_CONFIG_TASK_HISTOGRAMS
+/**
+ * @brief This function copies, in a consistent way, the histograms of a task:
+ * the wakeup latency, from the release of the task (the expiration of its
+ * delay) to the task running again, and the response time, from the release
+ * of each job to its completion. Both are measured in CPU cycles.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [out] wakeup_latency receives the wakeup latency histogram; it can be NULL
+ * @param [out] response_time receives the response time histogram; it can be NULL
+ * @retval None
+ */
+void get_task_histograms(mariOS_task_id_t task_id, mariOS_histogram* wakeup_latency, mariOS_histogram* response_time);
+#endif
+
 /**
  * @brief This function represents the core of mariOS.
  * As a common implementation along RTOS projects, the systick handler must take care
@@ -260,6 +560,22 @@ void mariOS_delay(uint32_t ticks);
  */
 void mariOS_systick_handler(void);
 
+/**
+ * @brief This function must be called at the end of an interrupt handler that
+ * invoked the ISR-safe API of mariOS (e.g., enqueue_from_isr()).
+ * Those functions never switch context by themselves, they just report
+ * whether they made ready a task with a priority higher than the interrupted
+ * one. If so, this function calls the scheduler and pends the PendSV_Handler(),
+ * which performs the context switch once the ISR returns.
+ * Since the flag can be accumulated over several calls, many events raised
+ * by the same ISR cost one context switch at most.
+ *
+ * @param [in] higher_priority_task_woken is nonzero if a task with higher
+ * 			   priority has been made ready by the ISR
+ * @retval None
+ */
+void mariOS_yield_from_isr(uint8_t higher_priority_task_woken);
+
 /**
  * @brief This accessory function returns the mariOS_task_id of the current active task
  * @param  None
@@ -276,7 +592,8 @@ mariOS_task_id_t get_current_task_id(void);
 void set_current_task_status(mariOS_task_status_t status);
 
 /**
- * @brief This accessory function configure the status of the a task
+ * @brief This accessory function configure the status of the a task.
+ * Making a task ready disarms its timeout, if any.
  *
  * @param [in] task_id is the id of the task to modify
  * @param [in] status is the new status of current active task
@@ -312,13 +629,182 @@ uint32_t get_current_task_period(void);
  */
 mariOS_task_status_t get_task_status(mariOS_task_id_t task_id);
 
+/**
+ * @brief This function suspends the current active task, setting its status to
+ * ::MARIOS_TASK_STATUS_SUSPEND, until another task or an ISR makes it ready or
+ * timeout_ticks elapse. It is meant for kernel objects: it must be invoked inside
+ * a critical section, after the task has been registered as a waiter of the
+ * object, and the suspension takes effect once the critical section ends.
+ * Once resumed, mariOS_timeout_expired() tells if the timeout elapsed.
+ *
+ * @param [in] timeout_ticks is the maximum number of ticks to wait, or
+ * 			   ::MARIOS_WAIT_FOREVER
+ * @retval None
+ */
+void mariOS_suspend_current_task(uint32_t timeout_ticks);
+
+/**
+ * @brief This function returns nonzero if the last suspension of the current
+ * active task ended because its timeout elapsed.
+ *
+ * @param None
+ * @return 1 if the timeout expired, 0 otherwise
+ */
+uint8_t mariOS_timeout_expired(void);
+
+/**
+ * @brief This function inserts a task into a wait list, according to its
+ * priority. It must be invoked inside a critical section.
+ *
+ * @param [in,out] list is the wait list
+ * @param [in] task_id is the ID of the task to insert
+ * @retval None
+ */
+void mariOS_wait_list_insert(mariOS_wait_list* list, mariOS_task_id_t task_id);
+
+/**
+ * @brief This function removes the task with the highest priority from a wait
+ * list. It must be invoked inside a critical section.
+ *
+ * @param [in,out] list is the wait list
+ * @return the ID of the removed task, or ::MARIOS_INVALID_TASK_ID if the list is empty
+ */
+mariOS_task_id_t mariOS_wait_list_pop(mariOS_wait_list* list);
+
+/**
+ * @brief This function removes a given task from the wait list it is suspended
+ * upon, if any. It must be invoked inside a critical section.
+ *
+ * @param [in] task_id is the ID of the task to remove
+ * @return 1 if the task was into a wait list, 0 otherwise
+ */
+uint8_t mariOS_wait_list_remove(mariOS_task_id_t task_id);
+
+/**
+ * @brief This accessory function returns the control block of a given task.
+ * It is meant for kernel objects that need to extend the task state.
+ *
+ * @param [in] task_id is the ID of the task
+ * @return the pointer to the task control block
+ */
+mariOS_task_control_block_t* get_task_control_block(mariOS_task_id_t task_id);
+
+/**
+ * @brief This accessory function returns the statistics of a given task.
+ * It is meant for kernel objects that account for their effects on tasks.
+ *
+ * @param [in] task_id is the ID of the task
+ * @return the pointer to the task statistics
+ */
+mariOS_task_statistics_block_t* get_task_statistics_block(mariOS_task_id_t task_id);
+
+/**
+ * @brief This function removes the task with the lowest ID from a task set.
+ * It must be invoked inside a critical section.
+ *
+ * @param [in,out] set is the task set
+ * @return the ID of the removed task, or ::MARIOS_INVALID_TASK_ID if the set is empty
+ */
+mariOS_task_id_t mariOS_task_set_pop(mariOS_task_set* set);
+
+/**
+ * @brief This accessory function configures the effective priority of a task.
+ * If the task is suspended upon a wait list, its position is updated.
+ *
+ * @param [in] task_id is the ID of the task
+ * @param [in] priority is the new priority
+ * @retval None
+ */
+void set_task_priority(mariOS_task_id_t task_id, mariOS_priority priority);
+
+/**
+ * @brief This accessory function returns the priority of a given task
+ *
+ * @param [in] task_id is the ID of the task
+ * @return the priority of the task_id task
+ */
+mariOS_priority get_task_priority(mariOS_task_id_t task_id);
+
+/**
+ * @brief This function returns the number of ticks elapsed since mariOS_init().
+ * Unlike #mariOS_ticks, the count does not wrap around. It can be invoked
+ * from any context, interrupt handlers and critical sections included.
+ *
+ * @param None
+ * @return the 64-bit tick count
+ */
+uint64_t get_ticks64(void);
+
+/**
+ * @brief This function returns a time stamp in cycles of the systick clock,
+ * namely the 64-bit tick count times the cycles per tick plus the cycles
+ * elapsed since the last tick, as read from the system timer. It can be
+ * invoked from any context: a tick elapsed while interrupts are masked is
+ * taken into account, provided that no more than one is pending.
+ *
+ * @param None
+ * @return the cycles elapsed since mariOS_init()
+ */
+uint64_t get_time_cycles(void);
+
+/**
+ * @brief This function is the same as get_time_cycles(), but the time stamp
+ * is expressed in microseconds.
+ *
+ * @param None
+ * @return the microseconds elapsed since mariOS_init()
+ */
+uint64_t get_time_us(void);
+
 /**
  * @brief This function returns, in percentage, the idle of the processor
+ * during the last statistics window.
  *
  * @param None
  * @return the idle of the processor, between 0 and 100
  */
 uint8_t get_idle_percentage(void);
 
+/**
+ * Value painted onto the stacks at task creation: the words that still hold
+ * it have never been used, which gives the stack high-water mark.
+ */
+#define MARIOS_STACK_PAINT			0xA5A5A5A5
+
+/**
+ * @brief This struct is a snapshot of the statistics of a task.
+ * CPU usage is accounted in cycles over windows of ::MARIOS_CONFIG_STATS_WINDOW_TICKS
+ * ticks: cpu_cycles[0] is the last completed window, cpu_cycles[1] the one
+ * before and so on.
+ */
+typedef struct task_info_t
+{
+	mariOS_task_id_t id;								/** the ID of the task */
+	mariOS_task_status_t status;						/** the status of the task */
+	mariOS_priority priority;							/** the effective priority of the task */
+	mariOS_priority base_priority;						/** the priority assigned to the task */
+	uint32_t cpu_cycles[MARIOS_CONFIG_STATS_WINDOWS];	/** cycles executed in the last windows */
+	uint32_t voluntary_switches;						/** switches due to the task waiting or suspending */
+	uint32_t preemptions;								/** switches due to a task with higher priority */
+	uint32_t queue_blocks;								/** times the task blocked on a queue */
+	uint32_t deadline_misses;							/** jobs completed after their deadline */
+	uint32_t skipped_releases;							/** releases dropped by ::MARIOS_OVERRUN_SKIP */
+	uint32_t max_execution_cycles;						/** longest job, namely the observed WCET */
+	uint32_t stack_size;								/** size of the stack in words */
+	uint32_t stack_high_water;							/** maximum number of stack words ever used */
+} mariOS_task_info;
+
+/**
+ * @brief This function takes a snapshot of the statistics of all tasks.
+ * Counters are copied in a single critical section, hence they are consistent
+ * with each other, while the stack high-water marks are measured afterwards,
+ * with interrupts enabled. Task 0 is the idle task.
+ *
+ * @param [out] info is the array receiving the statistics
+ * @param [in] max_tasks is the size of the array
+ * @return the number of tasks whose statistics have been copied
+ */
+uint16_t get_tasks_info(mariOS_task_info* info, uint16_t max_tasks);
+
 
 #endif
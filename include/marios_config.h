@@ -43,6 +43,31 @@
 
 #define MARIOS_SCHEDULER_FUNCTION		priority_scheduler
 
+#define MARIOS_CONFIG_DELAY_SPIN_CYCLES	2000	/* cycles spun at the end of mariOS_delay_us(), covering the wakeup latency */
+
+#define MARIOS_CONFIG_MAX_QUEUES		4	/* control blocks available to createQueue() */
+#define MARIOS_CONFIG_QUEUE_LAZY_RESET	0	/* 1: reset_queue() does not clear the queue memory */
+#define MARIOS_CONFIG_QUEUE_SET_SIZE	4
+#define MARIOS_CONFIG_QUEUE_STATS		0	/* 1: each queue keeps performance counters, listed by get_next_queue() */
+
+#define MARIOS_CONFIG_TIMERS				0	/* 1: software timers are serviced by the systick handler, 0: timers never expire */
+#define MARIOS_CONFIG_TIMER_DAEMON			0	/* 1: timer callbacks run in a daemon task, which takes a task slot, 0: inside the tick handler */
+#define MARIOS_CONFIG_TIMER_WHEEL_SIZE		32	/* slots of the timer wheel, a power of 2 */
+#define MARIOS_CONFIG_TIMER_DAEMON_PRIORITY	MARIOS_MAXIMUM_PRIORITY
+#define MARIOS_CONFIG_TIMER_DAEMON_STACK	(MARIOS_MINIMUM_TASK_STACK_SIZE*2)
+
+#define MARIOS_CONFIG_HEAP_SIZE				0	/* bytes of the kernel heap behind mariOS_malloc(), 0 leaves it out */
+#define MARIOS_CONFIG_HEAP_MAX_BLOCK_LOG2	20	/* heaps hand out blocks smaller than 2^20 bytes */
+
+#define MARIOS_CONFIG_TRACE					0	/* 1: kernel events are recorded into a ring buffer */
+#define MARIOS_CONFIG_TRACE_EVENTS			256	/* events of the ring buffer, a power of 2 */
+
+#define MARIOS_CONFIG_TASK_HISTOGRAMS		0	/* 1: wakeup latency and response time histograms of each task */
+#define MARIOS_CONFIG_HISTOGRAM_BUCKETS		24	/* log2 buckets: the last one counts samples from 2^22 cycles */
+
+#define MARIOS_CONFIG_STATS_WINDOWS			4	/* windows of CPU usage kept for each task */
+#define MARIOS_CONFIG_STATS_WINDOW_TICKS	MARIOS_CONFIG_SYSTICK_FREQ_DIV	/* ticks of a window (1 second) */
+
 
 
 #endif /* MARIOS_CONFIG_H_ */
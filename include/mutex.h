@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	mutex.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS mutex. This file contains the mutex
+ * 			structure and the accessory functions to lock and unlock it.
+ * 			mariOS mutexes are recursive and implement the priority
+ * 			inheritance protocol.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef MUTEX_H_
+#define MUTEX_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This enum lists the possible outcomes of mutex operations.
+ * ::MARIOS_MUTEX_SUCCESS_OP indicates a success operation
+ * ::MARIOS_MUTEX_TIMEOUT_OP indicates that the mutex has not been locked
+ * within the timeout (or immediately, if the timeout is 0), while
+ * ::MARIOS_MUTEX_NOT_OWNER_OP indicates that the caller tried to unlock a
+ * mutex it does not own.
+ */
+typedef enum
+{
+	MARIOS_MUTEX_SUCCESS_OP,		/**< Mutex operation successfully completes					*/
+	MARIOS_MUTEX_TIMEOUT_OP,		/**< Mutex has not been locked within the timeout			*/
+	MARIOS_MUTEX_NOT_OWNER_OP		/**< Mutex is not owned by the caller						*/
+} mariOS_mutex_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS mutex.
+ * A mutex tracks its owner and how many times the owner locked it, while the
+ * tasks waiting for it are kept into a priority-ordered wait list. Mutexes
+ * owned by the same task are linked together, so that the owner priority can
+ * be recomputed whenever one of them is released.
+ */
+typedef struct mutex_t
+{
+	volatile mariOS_task_id_t owner;		/** the task owning the mutex, ::MARIOS_INVALID_TASK_ID if free */
+	volatile uint32_t lock_count;			/** how many times the owner locked the mutex */
+	mariOS_wait_list waiting_tasks;			/** tasks that are blocked waiting to lock the mutex */
+	struct mutex_t* next_held;				/** next mutex owned by the same task */
+} mariOS_mutex;
+
+/**
+ * This macro expands to the compile-time initializer of a free ::mariOS_mutex.
+ */
+#define MARIOS_MUTEX_INITIALIZER { MARIOS_INVALID_TASK_ID, 0, MARIOS_WAIT_LIST_INITIALIZER, NULL }
+
+/**
+ * This macro simplifies operations to define a mariOS mutex, which is
+ * statically allocated and initialized free.
+ */
+#define mariOS_Mutex_Define(mutex_name) static mariOS_mutex mutex_name = MARIOS_MUTEX_INITIALIZER
+
+/**
+ * @brief The function initializes a mutex as free.
+ *
+ * @param [out] mutex is the mutex handler
+ * @retval None
+ */
+void initMutex(mariOS_mutex* mutex);
+
+/**
+ * @brief The lock_mutex function tries to acquire the mutex for the current
+ * active task.
+ * If the mutex is free, or it is already owned by the caller (mutexes are
+ * recursive), the function returns immediately without calling the scheduler.
+ *
+ * Otherwise, the task is suspended into the mutex wait list for timeout_ticks
+ * at most. Meanwhile, the owner inherits the priority of the caller, if higher;
+ * the inheritance is transitive, namely it is propagated to the owner of the
+ * mutex the owner is waiting for, and so on. Whenever the mutex is released,
+ * it is directly handed over to the waiting task with the highest priority.
+ *
+ * @param [in,out] mutex is the mutex handler
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until the mutex is acquired
+ * @return ::MARIOS_MUTEX_SUCCESS_OP or ::MARIOS_MUTEX_TIMEOUT_OP
+ */
+mariOS_mutex_op_status_t lock_mutex(mariOS_mutex* mutex, uint32_t timeout_ticks);
+
+/**
+ * @brief The unlock_mutex function releases the mutex once it has been
+ * unlocked as many times as it has been locked by the owner.
+ * At that point, the owner gets back the priority it would have without the
+ * released mutex and the mutex is handed over to the waiting task with the
+ * highest priority, if any; the caller is preempted whenever such a task has
+ * a higher priority.
+ *
+ * @param [in,out] mutex is the mutex handler
+ * @return ::MARIOS_MUTEX_SUCCESS_OP or ::MARIOS_MUTEX_NOT_OWNER_OP
+ */
+mariOS_mutex_op_status_t unlock_mutex(mariOS_mutex* mutex);
+
+#endif /* MUTEX_H_ */
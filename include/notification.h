@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	notification.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS direct-to-task notifications. Each task owns
+ * 			a 32-bit notification word that can be written by other tasks and
+ * 			interrupt handlers, which is the cheapest way to pass a value or a
+ * 			count to a task, or to use it as a binary or counting semaphore.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef NOTIFICATION_H_
+#define NOTIFICATION_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This enum lists how a notification updates the notification word.
+ */
+typedef enum
+{
+	MARIOS_NOTIFY_SET_BITS,			/**< The value is ORed into the word							*/
+	MARIOS_NOTIFY_INCREMENT,		/**< The word is incremented, the value is ignored				*/
+	MARIOS_NOTIFY_OVERWRITE,		/**< The value overwrites the word								*/
+	MARIOS_NOTIFY_SET_IF_EMPTY		/**< The value overwrites the word if no notification is pending	*/
+} mariOS_notify_action_t;
+
+/**
+ * @brief This enum lists how take_notification consumes the notification word.
+ */
+typedef enum
+{
+	MARIOS_NOTIFY_TAKE_CLEAR,		/**< The word is cleared, like taking a binary semaphore		*/
+	MARIOS_NOTIFY_TAKE_DECREMENT	/**< The word is decremented, like taking a counting semaphore	*/
+} mariOS_notify_take_t;
+
+/**
+ * @brief This enum lists the possible outcomes of notification operations.
+ * ::MARIOS_NOTIFY_SUCCESS_OP indicates a success operation
+ * ::MARIOS_NOTIFY_PENDING_OP indicates that ::MARIOS_NOTIFY_SET_IF_EMPTY has
+ * been refused since a notification is still pending, while
+ * ::MARIOS_NOTIFY_TIMEOUT_OP indicates that no notification has been received
+ * within the timeout (or immediately, if the timeout is 0).
+ */
+typedef enum
+{
+	MARIOS_NOTIFY_SUCCESS_OP,		/**< Notification operation successfully completes			*/
+	MARIOS_NOTIFY_PENDING_OP,		/**< The word has not been written since it is still pending	*/
+	MARIOS_NOTIFY_TIMEOUT_OP		/**< No notification has been received within the timeout		*/
+} mariOS_notify_op_status_t;
+
+/**
+ * @brief The notify_task function updates the notification word of a task
+ * according to action and marks the notification as pending. If the task is
+ * waiting for a notification, it is directly made ready, and it preempts the
+ * caller if it has a higher priority.
+ *
+ * @param [in] task_id is the ID of the task to notify
+ * @param [in] value is the notification value
+ * @param [in] action specifies how the notification word is updated
+ * @return ::MARIOS_NOTIFY_SUCCESS_OP or ::MARIOS_NOTIFY_PENDING_OP
+ */
+mariOS_notify_op_status_t notify_task(mariOS_task_id_t task_id, uint32_t value, mariOS_notify_action_t action);
+
+/**
+ * @brief The notify_task_from_isr function is the notify_task that can be
+ * safely invoked by an interrupt handler. It never calls the scheduler: if
+ * the task made ready has a priority higher than the interrupted one,
+ * higher_priority_task_woken is set to 1, to be passed to
+ * mariOS_yield_from_isr() before returning from the ISR.
+ *
+ * @param [in] task_id is the ID of the task to notify
+ * @param [in] value is the notification value
+ * @param [in] action specifies how the notification word is updated
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return ::MARIOS_NOTIFY_SUCCESS_OP or ::MARIOS_NOTIFY_PENDING_OP
+ */
+mariOS_notify_op_status_t notify_task_from_isr(mariOS_task_id_t task_id, uint32_t value, mariOS_notify_action_t action, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The take_notification function waits for a notification to the
+ * current active task and consumes it.
+ * The value of the notification word is returned before being cleared or
+ * decremented, according to mode; a decremented word that is still greater
+ * than 0 stays pending.
+ *
+ * @param [in] mode specifies how the notification word is consumed
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until a notification is received
+ * @param [out] value is the notification word before it was consumed; it can be NULL
+ * @return ::MARIOS_NOTIFY_SUCCESS_OP or ::MARIOS_NOTIFY_TIMEOUT_OP
+ */
+mariOS_notify_op_status_t take_notification(mariOS_notify_take_t mode, uint32_t timeout_ticks, uint32_t* value);
+
+#endif /* NOTIFICATION_H_ */
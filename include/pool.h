@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	pool.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS fixed-block memory pools. A pool hands out blocks
+ * 			of the same size from a statically allocated buffer, in constant time
+ * 			and without any fragmentation.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * This macro rounds the size of a block up to a multiple of the word size,
+ * so that every block is word-aligned and can hold the free list link.
+ */
+#define MARIOS_POOL_BLOCK_SIZE(size) ((((size) + sizeof(uint32_t) - 1) / sizeof(uint32_t)) * sizeof(uint32_t))
+
+/**
+ * This macro returns the number of words of the buffer of a pool.
+ */
+#define MARIOS_POOL_BUFFER_WORDS(block_count, size) ((block_count) * (MARIOS_POOL_BLOCK_SIZE(size) / sizeof(uint32_t)))
+
+/**
+ * @brief This enum lists the possible outcomes of pool operations.
+ * ::MARIOS_POOL_SUCCESS_OP indicates a success operation, while
+ * ::MARIOS_POOL_INVALID_OP indicates that the block does not belong to the pool.
+ */
+typedef enum
+{
+	MARIOS_POOL_SUCCESS_OP,			/**< Pool operation successfully completes				*/
+	MARIOS_POOL_INVALID_OP			/**< The block does not belong to the pool				*/
+} mariOS_pool_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS memory pool.
+ * Free blocks are linked into a list through their first word, which holds
+ * the index of the next free block plus 1 (0 ends the list). Blocks that have
+ * never been allocated are not in the list: they are carved out of the buffer
+ * in order, so that a pool needs no initialization loop.
+ * Both the list and the carving index are updated by exclusive accesses,
+ * hence blocks can be allocated and freed by tasks and interrupt handlers
+ * without any critical section.
+ */
+typedef struct pool_t
+{
+	uint32_t* buffer;						/** memory of the blocks */
+	uint32_t block_size;					/** size of a block in bytes, rounded by MARIOS_POOL_BLOCK_SIZE */
+	uint32_t block_count;					/** number of blocks */
+	volatile uint32_t free_list;			/** index of the first free block plus 1, 0 if the list is empty */
+	volatile uint32_t carved;				/** number of blocks carved out of the buffer so far */
+	volatile uint32_t used;					/** number of allocated blocks */
+	volatile uint32_t high_water;			/** maximum number of blocks allocated at the same time */
+} mariOS_pool;
+
+/**
+ * This macro expands to the compile-time initializer of a ::mariOS_pool.
+ */
+#define MARIOS_POOL_INITIALIZER(buffer, size, count) { (buffer), MARIOS_POOL_BLOCK_SIZE(size), (count), 0, 0, 0, 0 }
+
+/**
+ * This macro simplifies operations to define a mariOS memory pool of
+ * block_count blocks of size bytes, which is statically allocated along with
+ * its buffer.
+ */
+#define mariOS_Pool_Define(pool_name, block_count, size) static uint32_t pool_name##_buffer[MARIOS_POOL_BUFFER_WORDS(block_count, size)]; \
+															static mariOS_pool pool_name = MARIOS_POOL_INITIALIZER(pool_name##_buffer, size, block_count)
+
+/**
+ * @brief The function initializes a memory pool over a buffer, which must be
+ * at least MARIOS_POOL_BUFFER_WORDS(block_count, block_size) words long.
+ * All the blocks are returned to the pool.
+ *
+ * @param [out] pool is the pool handler
+ * @param [in] buffer is the memory of the blocks
+ * @param [in] block_size is the size of a block in bytes
+ * @param [in] block_count is the number of blocks
+ * @retval None
+ */
+void initPool(mariOS_pool* pool, uint32_t* buffer, uint32_t block_size, uint32_t block_count);
+
+/**
+ * @brief The allocate_block function takes a block from the pool in constant
+ * time. It can be invoked by interrupt handlers.
+ *
+ * @param [in,out] pool is the pool handler
+ * @return the address of the block, or NULL if the pool is exhausted
+ */
+void* allocate_block(mariOS_pool* pool);
+
+/**
+ * @brief The allocate_zeroed_block function is the allocate_block that also
+ * sets the content of the block to zero.
+ *
+ * @param [in,out] pool is the pool handler
+ * @return the address of the block, or NULL if the pool is exhausted
+ */
+void* allocate_zeroed_block(mariOS_pool* pool);
+
+/**
+ * @brief The free_block function returns a block to the pool in constant
+ * time. It can be invoked by interrupt handlers.
+ *
+ * @param [in,out] pool is the pool handler
+ * @param [in] block is the address of a block allocated from the pool
+ * @return ::MARIOS_POOL_SUCCESS_OP or ::MARIOS_POOL_INVALID_OP
+ */
+mariOS_pool_op_status_t free_block(mariOS_pool* pool, void* block);
+
+/**
+ * @brief The function returns the number of blocks currently allocated.
+ *
+ * @param [in] pool is the pool handler
+ * @return the number of allocated blocks
+ */
+uint32_t get_pool_used_blocks(mariOS_pool* pool);
+
+/**
+ * @brief The function returns the maximum number of blocks that have been
+ * allocated at the same time, which helps to size the pool.
+ *
+ * @param [in] pool is the pool handler
+ * @return the high-water mark of the pool
+ */
+uint32_t get_pool_high_water(mariOS_pool* pool);
+
+#endif /* POOL_H_ */
@@ -87,7 +87,8 @@ uint32_t* initialize_Stack(uint32_t* stack_ptr, void (*task_handler)(void), void
  * the execution context of marios_next_task is restored by replay same steps,
  * but in opposite direction. First, the stack pointer of marios_next_task is
  * loaded, then registers are restored, except for the first 4 which will be
- * automatically restored at the exit.
+ * automatically restored at the exit. Finally, marios_curr_task is updated to
+ * marios_next_task, as the latter is now the task owning the CPU.
  *
  * @param None
  * @retval None
@@ -124,6 +125,153 @@ void enter_critical_section();
  */
 void exit_critical_sction();
 
+/**
+ * @brief The functions load_exclusive and store_exclusive implement a
+ * load-linked/store-conditional pair, which allows kernel objects to update a
+ * word atomically without disabling interrupts: store_exclusive succeeds if
+ * and only if no other access (or exception) occurred on the word after the
+ * load_exclusive. An exclusive load that is not followed by a store must be
+ * abandoned by calling clear_exclusive.
+ *
+ * As for ARM Cortex M3 and M4, they map onto the LDREX, STREX and CLREX
+ * instructions. The exclusive monitor is cleared on exception entry and exit,
+ * hence the sequence is safe against both tasks and interrupt handlers.
+ *
+ * @param address is the pointer to the word
+ * @retval the loaded value
+ */
+uint32_t load_exclusive(volatile uint32_t* address);
+
+/**
+ * @brief See load_exclusive.
+ *
+ * @param address is the pointer to the word
+ * @param value is the value to store
+ * @retval 0 if the store succeeded, 1 otherwise
+ */
+uint32_t store_exclusive(volatile uint32_t* address, uint32_t value);
+
+/**
+ * @brief See load_exclusive.
+ *
+ * @param None
+ * @retval None
+ */
+void clear_exclusive();
+
+/**
+ * @brief The function memory_barrier guarantees that every memory access
+ * issued before it completes before any access issued after it. Lock-free
+ * objects use it to publish data before the index that makes it visible.
+ *
+ * As for ARM Cortex M3 and M4, it maps onto the DMB instruction.
+ *
+ * @param None
+ * @retval None
+ */
+void memory_barrier();
+
+/**
+ * @brief The functions init_cycle_counter and read_cycle_counter provide a
+ * free-running counter of CPU cycles, used by the kernel to measure latencies
+ * far below the tick period. The counter wraps around, hence only differences
+ * between two readings are meaningful.
+ *
+ * As for ARM Cortex M3 and M4, it is the CYCCNT register of the DWT unit.
+ *
+ * @param None
+ * @retval the number of cycles counted so far (read_cycle_counter)
+ */
+void init_cycle_counter();
+
+/**
+ * @brief See init_cycle_counter.
+ */
+uint32_t read_cycle_counter();
+
+/**
+ * @brief The read_systick_elapsed function returns the clock cycles elapsed
+ * since the last reload of the system timer, which gives time stamps finer
+ * than the tick. If the reload has not been serviced yet, since interrupts
+ * are masked or a handler with higher priority is running, tick_pending is
+ * set.
+ *
+ * As for ARM Cortex M3 and M4, it reads the current value of SysTick, which
+ * counts down, and the PENDSTSET bit of the ICSR register.
+ *
+ * @param [out] tick_pending is set to 1 if a tick interrupt is pending, to 0 otherwise
+ * @retval the cycles elapsed since the last reload
+ */
+uint32_t read_systick_elapsed(uint8_t* tick_pending);
+
+/**
+ * @brief The function get_active_exception returns the number of the
+ * exception being handled, 0 in thread mode.
+ *
+ * @param None
+ * @retval the number of the active exception
+ */
+uint32_t get_active_exception();
+
+/**
+ * @brief The function is_isr_context tells whether the caller is executing
+ * inside an interrupt handler, which lets the kernel refuse (or redirect)
+ * calls that may block.
+ * As for ARM Cortex M3 and M4, the active exception number is read from the
+ * Interrupt Control and State Register.
+ *
+ * @param None
+ * @retval 1 if an interrupt handler is executing, 0 otherwise
+ */
+uint8_t is_isr_context();
+
+/**
+ * @brief The functions configure_job_interrupt and pend_job_interrupt bind a
+ * run-to-completion job (see srp.h) to an interrupt that is unused by the
+ * application: the job is released by pending the interrupt, and it runs in
+ * handler mode, on the main stack, at a priority given by its preemption level.
+ * Preemption level 0 is the priority of tasks, while higher levels preempt
+ * lower ones.
+ *
+ * As for ARM Cortex M3 and M4, level L is mapped onto the NVIC priority
+ * (2^__NVIC_PRIO_BITS - 1 - L), in between PendSV (lowest) and SysTick (highest).
+ *
+ * @param irq_number is the number of the interrupt
+ * @param level is the preemption level of the job
+ * @retval None
+ */
+void configure_job_interrupt(int32_t irq_number, uint8_t level);
+
+/**
+ * @brief See configure_job_interrupt.
+ *
+ * @param irq_number is the number of the interrupt
+ * @retval None
+ */
+void pend_job_interrupt(int32_t irq_number);
+
+/**
+ * @brief The function raise_preemption_threshold prevents jobs whose
+ * preemption level is not greater than level from preempting the caller,
+ * while leaving higher levels (and the systick) enabled. The threshold is
+ * never lowered, and the previous one is returned to be passed to
+ * restore_preemption_threshold.
+ *
+ * As for ARM Cortex M3 and M4, the threshold is the BASEPRI register.
+ *
+ * @param level is the preemption level to mask
+ * @retval the previous threshold
+ */
+uint32_t raise_preemption_threshold(uint8_t level);
+
+/**
+ * @brief See raise_preemption_threshold.
+ *
+ * @param threshold is the value returned by raise_preemption_threshold
+ * @retval None
+ */
+void restore_preemption_threshold(uint32_t threshold);
+
 /**
  * @brief The configureSystick function hides the main mechanism on which an RTOS is
  * based, that is periodic interrupts from a system timer.
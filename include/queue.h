@@ -76,20 +76,71 @@ typedef enum
  * is full (nothing can be enqueued) or is empty (nothing can be dequeued);
  * they can be returned if and only if MARIOS_NONBLOCKING_QUEUE_OP is used
  * when @enqueue and @dequeue functions are invoked.
+ * ::MARIOS_QUEUE_OVERSIZE_OP is returned by framed queues only, when a
+ * message can never be enqueued or does not fit the reader buffer.
  */
 typedef enum
 {
 	MARIOS_QUEUE_SUCCESS_OP, 	/**< Queue operation successfully completes						*/
 	MARIOS_QUEUE_BUSY_OP,		/**< Queue operation fails due to busy status of the queue		*/
 	MARIOS_QUEUE_FULL_OP,		/**< Enqueue on ::mariOS_queue fails since it is full			*/
-	MARIOS_QUEUE_EMPTY_OP		/**< Dequeue on ::mariOS_queue fails since it is empty			*/
+	MARIOS_QUEUE_EMPTY_OP,		/**< Dequeue on ::mariOS_queue fails since it is empty			*/
+	MARIOS_QUEUE_OVERSIZE_OP	/**< Framed message does not fit the queue or the reader buffer	*/
 } mariOS_queue_op_status_t;
 
+/**
+ * @brief This enum selects how a queue stores its messages.
+ * ::MARIOS_QUEUE_STREAM_MODE is the original byte stream: the reader must
+ * know the size of the message it is going to dequeue.
+ * ::MARIOS_QUEUE_FRAMED_MODE prepends a ::mariOS_queue_frame_header_t to
+ * each message, hence messages of different sizes can share the queue and
+ * are always dequeued as a whole.
+ */
+typedef enum
+{
+	MARIOS_QUEUE_STREAM_MODE,	/**< Messages are a raw byte stream								*/
+	MARIOS_QUEUE_FRAMED_MODE	/**< Each message is stored along with its length				*/
+} mariOS_queue_mode_t;
+
+/**
+ * Length header stored in front of each message of a framed queue.
+ * It limits the size of a single framed message to 65535 bytes.
+ */
+typedef uint16_t mariOS_queue_frame_header_t;
+
+/**
+ * The amount of queue memory consumed by each framed message in addition
+ * to its payload.
+ */
+#define MARIOS_QUEUE_FRAME_HEADER_SIZE	sizeof(mariOS_queue_frame_header_t)
+
+struct queue_set_t;
+
+/**
+ * @brief This struct collects the performance counters of a queue, kept
+ * only if ::MARIOS_CONFIG_QUEUE_STATS is set (see get_queue_stats()).
+ * Blocked times are expressed in CPU cycles, as read by read_cycle_counter().
+ */
+typedef struct
+{
+	uint32_t messages_in;											/** messages successfully enqueued */
+	uint32_t messages_out;											/** messages successfully dequeued */
+	uint32_t bytes_in;												/** payload bytes enqueued, frame headers excluded */
+	uint32_t bytes_out;												/** payload bytes dequeued, frame headers excluded */
+	uint32_t full_rejections;										/** non-blocking enqueues refused since the queue was full */
+	uint32_t empty_rejections;										/** non-blocking dequeues refused since the queue was empty */
+	uint32_t busy_retries;											/** operations that found the queue locked */
+	uint32_t peak_occupancy;										/** highest number of bytes stored at once, headers included */
+	uint64_t blocked_cycles_total;									/** cycles spent by tasks suspended on the queue */
+	uint32_t blocked_cycles_max;									/** longest single suspension on the queue */
+	uint32_t wrap_copies;											/** copies split across the end of the queue memory */
+} mariOS_queue_stats;
+
 /**
  * @brief This struct is used to typedef the mariOS queue. It is a cyclic queue
  * with pointers to the head and tail.
- * The structure contains two arrays containing suspended task reference for
- * enqueue and dequeue operations.
+ * The structure contains two sets of the tasks suspended upon enqueue and
+ * dequeue operations, one bit per task.
  */
 typedef struct queue_t
 {
@@ -99,23 +150,88 @@ typedef struct queue_t
 	uint32_t size;													/** the memory sized reserved to the queue */
 	uint32_t freeMemory;											/** the free space on the queue */
 	int8_t* queueMemory;											/** the pointer to the queue memory */
+	struct queue_set_t* set;										/** the queue set the queue belongs to, if any */
+
+	mariOS_task_set tasks_waiting_to_send;							/** tasks that are blocked waiting to write into the queue. */
+	mariOS_task_set tasks_waiting_to_receive; 						/** tasks that are blocked waiting to read from the queue. */
 
-	uint8_t tasks_waiting_to_send[MARIOS_CONFIG_MAX_TASKS];			/** array of tasks that are blocked waiting to write into the queue. */
-	uint8_t tasks_waiting_to_receive[MARIOS_CONFIG_MAX_TASKS]; 		/** array of tasks that are blocked waiting to read from the queue. */
+	uint8_t mode;													/** ::mariOS_queue_mode_t, stream or framed storage of messages */
+	volatile uint8_t rLock; 										/** ::mariOS_queue_status_t, lock the queue for reading operation */
+	volatile uint8_t wLock; 										/** ::mariOS_queue_status_t, lock the queue for writing operation */
 
-	volatile mariOS_queue_status_t rLock; 							/** lock the queue for reading operation */
-	volatile mariOS_queue_status_t wLock; 							/** lock the queue for writing operation */
+#if MARIOS_CONFIG_QUEUE_STATS
+	mariOS_queue_stats stats;										/** performance counters of the queue */
+	struct queue_t* next_queue;										/** next queue returned by get_next_queue() */
+	uint8_t registered;												/** 1 once the queue is listed by get_next_queue() */
+#endif
 } mariOS_queue;
 
+/**
+ * This macro expands to a compile-time initializer of a pristine ::mariOS_queue
+ * that uses the given buffer as queue's memory.
+ */
+#define MARIOS_QUEUE_INITIALIZER(buffer, buffer_size, queue_mode) { .head = 0, .tail = 0, .size = (buffer_size),\
+																	.freeMemory = (buffer_size), .queueMemory = (int8_t*)(buffer),\
+																	.mode = (queue_mode), .rLock = MARIOS_QUEUE_UNLOCKED,\
+																	.wLock = MARIOS_QUEUE_UNLOCKED, .set = NULL }
+
+/**
+ * @brief This struct is used to typedef the mariOS queue set. A queue set
+ * groups up to ::MARIOS_CONFIG_QUEUE_SET_SIZE queues, so that a task can
+ * block once until any of them has data (see select_from_queue_set()).
+ * A queue can belong to one set at a time.
+ */
+typedef struct queue_set_t
+{
+	mariOS_queue* members[MARIOS_CONFIG_QUEUE_SET_SIZE];			/** queues registered into the set */
+	uint8_t size;													/** number of registered queues */
+	uint8_t last_selected;											/** index of the last queue returned, for fairness */
+
+	mariOS_task_set tasks_waiting_to_select;						/** tasks that are blocked waiting for a member to get data */
+} mariOS_queue_set;
+
+/**
+ * This macro simplifies operations to define a mariOS queue set, which is
+ * statically allocated and initialized empty.
+ */
+#define mariOS_Queue_Set_Define(set_name) static mariOS_queue_set set_name = { {NULL}, 0, 0, MARIOS_TASK_SET_INITIALIZER }
+
+/**
+ * @brief The function initialize a mariOS_queue structure provided by the
+ * caller, which is useful whenever the control block cannot be defined by
+ * means of mariOS_Queue_Define.
+ *
+ * @param [out] queue is the control block to initialize
+ * @param [in] buffer used as queue's memory
+ * @param [in] size is the queue size in bytes
+ * @param [in] mode specifies if messages are stored as a stream or framed
+ * @retval None
+ */
+void initQueue(mariOS_queue* queue, uint8_t* buffer, unsigned int size, mariOS_queue_mode_t mode);
+
 /**
  * @brief The function initialize a mariOS_queue structure with a specified size.
+ * The control block is taken from a static table of ::MARIOS_CONFIG_MAX_QUEUES
+ * entries, hence no heap is used.
  *
  * @param [in] buffer used as queue's memory
  * @param [in] size is the queue size in bytes
- * @return pointer to the ::mariOS_queue created
+ * @return pointer to the ::mariOS_queue created, or NULL if no control block is left
  */
 mariOS_queue* createQueue(uint8_t* buffer, unsigned int size);
 
+/**
+ * @brief The function initialize a framed mariOS_queue structure with a
+ * specified size. Each message enqueued is stored along with a
+ * ::mariOS_queue_frame_header_t, so that readers can retrieve it without
+ * knowing its size in advance (see dequeue_frame() and peek_frame_size()).
+ *
+ * @param [in] buffer used as queue's memory
+ * @param [in] size is the queue size in bytes, headers included
+ * @return pointer to the ::mariOS_queue created, or NULL if no control block is left
+ */
+mariOS_queue* createFramedQueue(uint8_t* buffer, unsigned int size);
+
 /**
  * @brief The enqueue function tries to put a message onto the specified \
  * queue.
@@ -142,6 +258,11 @@ mariOS_queue* createQueue(uint8_t* buffer, unsigned int size);
  * Conversely, if the enqueue succeeds, no matter if blocking or not,
  * the function returns ::MARIOS_QUEUE_SUCCESS_OP.
  *
+ * On a framed queue, the message is stored along with its length header
+ * and header and payload are written as a whole. A message that cannot
+ * fit the queue even when it is empty is refused with
+ * ::MARIOS_QUEUE_OVERSIZE_OP, no matter if blocking or not.
+ *
  * @param [in,out] queue is the mariOS_queue handler on which the message should be
  * 				   enqueued
  * @param [in] msg is the pointer to the message that has to be enqueued
@@ -178,6 +299,9 @@ mariOS_queue_op_status_t enqueue(mariOS_queue* queue, uint8_t* msg, unsigned int
  * Conversely, if the dequeue succeeds, no matter if blocking or not,
  * the function returns ::MARIOS_QUEUE_SUCCESS_OP.
  *
+ * On a framed queue, dequeue behaves like dequeue_frame() with size
+ * being the capacity of msg.
+ *
  * @param [in,out] queue is the mariOS_queue handler from which the message should be
  * 				   dequeued
  * @param [out] msg is the pointer on which the message will be stored
@@ -187,12 +311,162 @@ mariOS_queue_op_status_t enqueue(mariOS_queue* queue, uint8_t* msg, unsigned int
  */
 mariOS_queue_op_status_t dequeue(mariOS_queue* queue, uint8_t* msg, unsigned int size, mariOS_blocking_queue_op_t blocking);
 
+/**
+ * @brief The enqueue_from_isr function is the non-blocking enqueue that can be
+ * safely invoked by an interrupt handler.
+ * It behaves like enqueue() with ::MARIOS_NONBLOCKING_QUEUE_OP, but it never
+ * calls the scheduler: tasks waiting to receive from the queue are made ready
+ * and, if at least one of them has a priority higher than the interrupted task,
+ * higher_priority_task_woken is set to 1 (it is never cleared, hence it can be
+ * shared among several calls). The ISR must pass it to mariOS_yield_from_isr()
+ * before returning.
+ *
+ * @param [in,out] queue is the mariOS_queue handler on which the message should be
+ * 				   enqueued
+ * @param [in] msg is the pointer to the message that has to be enqueued
+ * @param [in] size is the message size (in bytes)
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return operation success or failure
+ */
+mariOS_queue_op_status_t enqueue_from_isr(mariOS_queue* queue, uint8_t* msg, unsigned int size, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The dequeue_from_isr function is the non-blocking dequeue that can be
+ * safely invoked by an interrupt handler.
+ * It behaves like dequeue() with ::MARIOS_NONBLOCKING_QUEUE_OP, while tasks
+ * waiting to send are handled as described for enqueue_from_isr().
+ *
+ * @param [in,out] queue is the mariOS_queue handler from which the message should be
+ * 				   dequeued
+ * @param [out] msg is the pointer on which the message will be stored
+ * @param [in] size is the message size (in bytes)
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return operation success or failure
+ */
+mariOS_queue_op_status_t dequeue_from_isr(mariOS_queue* queue, uint8_t* msg, unsigned int size, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The dequeue_frame function pulls the next whole message from a
+ * framed queue, whatever its size.
+ * Blocking, busy and empty conditions are handled as for dequeue(). If the
+ * next message is larger than max_size, it is left into the queue and the
+ * function returns ::MARIOS_QUEUE_OVERSIZE_OP, so that the caller can
+ * retrieve its size by means of peek_frame_size() and retry.
+ *
+ * @param [in,out] queue is the framed mariOS_queue handler
+ * @param [out] msg is the pointer on which the message will be stored
+ * @param [in] max_size is the capacity (in bytes) of msg
+ * @param [out] msg_size is the size of the dequeued message; it can be NULL
+ * @param [in] blocking specifies if the dequeue is blocking or not
+ * @return operation success or failure
+ */
+mariOS_queue_op_status_t dequeue_frame(mariOS_queue* queue, uint8_t* msg, unsigned int max_size, unsigned int* msg_size, mariOS_blocking_queue_op_t blocking);
+
+/**
+ * @brief The peek_frame_size function returns the size of the next message
+ * of a framed queue without removing it. It never blocks.
+ *
+ * @param [in] queue is the framed mariOS_queue handler
+ * @param [out] msg_size is the size (in bytes) of the next message
+ * @return ::MARIOS_QUEUE_SUCCESS_OP, ::MARIOS_QUEUE_BUSY_OP or ::MARIOS_QUEUE_EMPTY_OP
+ */
+mariOS_queue_op_status_t peek_frame_size(mariOS_queue* queue, unsigned int* msg_size);
+
 /**
  * @brief The function restore the queue in a pristine state.
+ * Unless ::MARIOS_CONFIG_QUEUE_LAZY_RESET is set, the queue memory is
+ * cleared as well.
  *
  * @param [in,out] queue is the queue handler
  * @retval None
  */
 void reset_queue(mariOS_queue* queue);
 
+/**
+ * @brief The function iterates over the queues known to the kernel, which are
+ * those initialized by initQueue(), createQueue() and createFramedQueue(),
+ * as well as those defined by ::MARIOS_QUEUE_INITIALIZER once they have been
+ * operated at least once.
+ * It returns NULL, and the list is empty, unless ::MARIOS_CONFIG_QUEUE_STATS
+ * is set.
+ *
+ * @param [in] queue is the queue returned by the previous call, or NULL to get the first one
+ * @return the next queue, or NULL if there are no more queues
+ */
+mariOS_queue* get_next_queue(mariOS_queue* queue);
+
+/**
+ * @brief The function removes a queue from the list walked by get_next_queue().
+ * It must be invoked before the control block of a queue that is not static,
+ * e.g. on the stack of a task, goes out of scope. The queue must not be
+ * operated afterwards, unless it is initialized again by initQueue().
+ * It has no effect unless ::MARIOS_CONFIG_QUEUE_STATS is set.
+ *
+ * @param [in,out] queue is the queue handler
+ * @retval None
+ */
+void unregister_queue(mariOS_queue* queue);
+
+/**
+ * @brief The function copies the performance counters of a queue, so that
+ * they are consistent with each other.
+ *
+ * @param [in] queue is the mariOS_queue handler
+ * @param [out] stats is the area on which counters are stored
+ * @return ::MARIOS_QUEUE_SUCCESS_OP, or ::MARIOS_QUEUE_EMPTY_OP if
+ * 		   ::MARIOS_CONFIG_QUEUE_STATS is not set
+ */
+mariOS_queue_op_status_t get_queue_stats(mariOS_queue* queue, mariOS_queue_stats* stats);
+
+/**
+ * @brief The function clears the performance counters of a queue. The peak
+ * occupancy restarts from the bytes currently stored.
+ * Note that reset_queue() leaves the counters untouched.
+ *
+ * @param [in,out] queue is the mariOS_queue handler
+ * @retval None
+ */
+void reset_queue_stats(mariOS_queue* queue);
+
+/**
+ * @brief The function registers a queue into a queue set.
+ *
+ * @param [in,out] set is the queue set handler
+ * @param [in,out] queue is the mariOS_queue handler to register
+ * @return ::MARIOS_QUEUE_SUCCESS_OP, ::MARIOS_QUEUE_FULL_OP if the set cannot contain
+ * 		   more queues or ::MARIOS_QUEUE_BUSY_OP if the queue already belongs to a set
+ */
+mariOS_queue_op_status_t add_to_queue_set(mariOS_queue_set* set, mariOS_queue* queue);
+
+/**
+ * @brief The function removes a queue from the queue set it has been registered into.
+ *
+ * @param [in,out] set is the queue set handler
+ * @param [in,out] queue is the mariOS_queue handler to remove
+ * @return ::MARIOS_QUEUE_SUCCESS_OP or ::MARIOS_QUEUE_EMPTY_OP if the queue is not a member of the set
+ */
+mariOS_queue_op_status_t remove_from_queue_set(mariOS_queue_set* set, mariOS_queue* queue);
+
+/**
+ * @brief The select_from_queue_set function returns a member of the set that
+ * has data to be dequeued. A stream queue is selected as soon as it holds one
+ * byte, while a framed queue is selected once it holds a whole message.
+ * Members are scanned starting from the one next to the last selected, so that
+ * a busy queue does not starve the others.
+ *
+ * If no member has data and ::MARIOS_BLOCKING_QUEUE_OP is passed, the task is
+ * suspended until an enqueue on any member occurs. If
+ * ::MARIOS_NONBLOCKING_QUEUE_OP is passed, the function returns NULL.
+ *
+ * The selected queue is not read: the task has to dequeue from it, which is
+ * expected to succeed unless another reader consumed the data in the meantime.
+ *
+ * @param [in,out] set is the queue set handler
+ * @param [in] blocking specifies if the select is blocking or not
+ * @return the mariOS_queue handler with data, or NULL
+ */
+mariOS_queue* select_from_queue_set(mariOS_queue_set* set, mariOS_blocking_queue_op_t blocking);
+
 #endif /* QUEUE_H_ */
@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	semaphore.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS semaphore. This file contains the counting
+ * 			semaphore structure and the accessory functions to take and give
+ * 			it, both from tasks and interrupt handlers.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef SEMAPHORE_H_
+#define SEMAPHORE_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This enum lists the possible outcomes of semaphore operations.
+ * ::MARIOS_SEMAPHORE_SUCCESS_OP indicates a success operation
+ * ::MARIOS_SEMAPHORE_TIMEOUT_OP indicates that no token has been taken
+ * within the timeout (or immediately, if the timeout is 0), while
+ * ::MARIOS_SEMAPHORE_FULL_OP indicates that a give has been refused since
+ * the semaphore already holds its maximum count.
+ */
+typedef enum
+{
+	MARIOS_SEMAPHORE_SUCCESS_OP,	/**< Semaphore operation successfully completes				*/
+	MARIOS_SEMAPHORE_TIMEOUT_OP,	/**< No token has been taken within the timeout				*/
+	MARIOS_SEMAPHORE_FULL_OP		/**< The semaphore already holds its maximum count			*/
+} mariOS_semaphore_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS semaphore.
+ * A non negative count is the number of available tokens, while a negative
+ * count is the number of tasks suspended into the wait list. Such encoding
+ * makes it possible to take and give an uncontended semaphore by means of a
+ * single exclusive update of the count, without any critical section.
+ */
+typedef struct semaphore_t
+{
+	volatile int32_t count;					/** available tokens, or the opposite of the number of waiting tasks */
+	int32_t max_count;						/** maximum number of tokens */
+	mariOS_wait_list waiting_tasks;			/** tasks that are blocked waiting for a token */
+} mariOS_semaphore;
+
+/**
+ * This macro expands to the compile-time initializer of a ::mariOS_semaphore.
+ */
+#define MARIOS_SEMAPHORE_INITIALIZER(initial_count, maximum_count) { (initial_count), (maximum_count), MARIOS_WAIT_LIST_INITIALIZER }
+
+/**
+ * These macros simplify operations to define a mariOS counting or binary
+ * semaphore, which is statically allocated and initialized.
+ */
+#define mariOS_Semaphore_Define(semaphore_name, initial_count, maximum_count) static mariOS_semaphore semaphore_name = \
+																				MARIOS_SEMAPHORE_INITIALIZER(initial_count, maximum_count)
+#define mariOS_Binary_Semaphore_Define(semaphore_name, initial_count) mariOS_Semaphore_Define(semaphore_name, initial_count, 1)
+
+/**
+ * @brief The function initializes a semaphore.
+ *
+ * @param [out] semaphore is the semaphore handler
+ * @param [in] initial_count is the number of tokens initially available
+ * @param [in] max_count is the maximum number of tokens (1 for a binary semaphore)
+ * @retval None
+ */
+void initSemaphore(mariOS_semaphore* semaphore, int32_t initial_count, int32_t max_count);
+
+/**
+ * @brief The take_semaphore function takes a token from the semaphore.
+ * If a token is available, it is taken by an exclusive update of the count,
+ * with neither critical section nor scheduler call.
+ * Otherwise, the task is suspended into the semaphore wait list, ordered by
+ * priority, for timeout_ticks at most.
+ *
+ * @param [in,out] semaphore is the semaphore handler
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until a token is taken
+ * @return ::MARIOS_SEMAPHORE_SUCCESS_OP or ::MARIOS_SEMAPHORE_TIMEOUT_OP
+ */
+mariOS_semaphore_op_status_t take_semaphore(mariOS_semaphore* semaphore, uint32_t timeout_ticks);
+
+/**
+ * @brief The give_semaphore function gives a token to the semaphore.
+ * If no task is waiting, the count is incremented by an exclusive update.
+ * Otherwise, the token is directly handed over to the waiting task with the
+ * highest priority, which preempts the caller if it has a higher priority.
+ *
+ * @param [in,out] semaphore is the semaphore handler
+ * @return ::MARIOS_SEMAPHORE_SUCCESS_OP or ::MARIOS_SEMAPHORE_FULL_OP
+ */
+mariOS_semaphore_op_status_t give_semaphore(mariOS_semaphore* semaphore);
+
+/**
+ * @brief The give_semaphore_from_isr function is the give that can be safely
+ * invoked by an interrupt handler. It never calls the scheduler: if the task
+ * made ready has a priority higher than the interrupted one,
+ * higher_priority_task_woken is set to 1, to be passed to
+ * mariOS_yield_from_isr() before returning from the ISR.
+ *
+ * @param [in,out] semaphore is the semaphore handler
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return ::MARIOS_SEMAPHORE_SUCCESS_OP or ::MARIOS_SEMAPHORE_FULL_OP
+ */
+mariOS_semaphore_op_status_t give_semaphore_from_isr(mariOS_semaphore* semaphore, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The function returns the number of tokens available.
+ *
+ * @param [in] semaphore is the semaphore handler
+ * @return the number of available tokens
+ */
+int32_t get_semaphore_count(mariOS_semaphore* semaphore);
+
+#endif /* SEMAPHORE_H_ */
@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	srp.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of the mariOS Stack Resource Policy. Run-to-completion jobs
+ * 			never block: they run in handler mode on the shared main stack, while the
+ * 			resources they share are protected by preemption ceilings.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef SRP_H_
+#define SRP_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * The highest preemption level of a job: the NVIC priorities in between PendSV
+ * and SysTick are available to jobs.
+ */
+#define MARIOS_SRP_MAX_LEVEL ((1 << __NVIC_PRIO_BITS) - 2)
+
+/**
+ * @brief This is the type of the function run each time a job is released.
+ * It must return once its work is done and it must never block, hence only
+ * the ISR-safe API of mariOS (e.g., give_semaphore_from_isr()) can be used.
+ */
+typedef void (*mariOS_job_handler_t)(void* argument);
+
+/**
+ * @brief This enum lists the possible outcomes of SRP operations.
+ * ::MARIOS_SRP_SUCCESS_OP indicates a success operation, while
+ * ::MARIOS_SRP_INVALID_LEVEL_OP indicates a preemption level out of range.
+ */
+typedef enum
+{
+	MARIOS_SRP_SUCCESS_OP,			/**< SRP operation successfully completes					*/
+	MARIOS_SRP_INVALID_LEVEL_OP		/**< The preemption level is out of range					*/
+} mariOS_srp_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS run-to-completion job.
+ * A job has neither a TCB nor a stack: it is bound to an interrupt that the
+ * application does not use, so that all the jobs run on the main stack.
+ * Since a job never blocks, a preempted job can only resume once the
+ * preempting one completes, hence the main stack must only fit the deepest
+ * job of each preemption level, rather than every job.
+ */
+typedef struct job_t
+{
+	mariOS_job_handler_t handler;			/** function run each time the job is released */
+	void* argument;							/** argument passed to the handler */
+	int32_t irq_number;						/** interrupt the job is bound to */
+	uint8_t level;							/** preemption level, from 1 to ::MARIOS_SRP_MAX_LEVEL */
+	volatile uint32_t releases;				/** releases that have not been served yet */
+} mariOS_job;
+
+/**
+ * @brief This struct is used to typedef a resource shared by jobs (and
+ * tasks). Its ceiling is the highest preemption level of the jobs using it:
+ * locking the resource masks every job that may use it, therefore a job is
+ * never blocked on a resource once it started, and deadlocks are impossible.
+ */
+typedef struct srp_resource_t
+{
+	uint8_t ceiling;						/** highest preemption level of the jobs using the resource */
+	uint32_t saved_threshold;				/** preemption threshold before the resource has been locked */
+} mariOS_srp_resource;
+
+/**
+ * These macros expand to the compile-time initializers of jobs and resources.
+ */
+#define MARIOS_JOB_INITIALIZER(job_handler, job_argument, irq, preemption_level) { (job_handler), (job_argument), (irq), (preemption_level), 0 }
+#define MARIOS_SRP_RESOURCE_INITIALIZER(resource_ceiling) { (resource_ceiling), 0 }
+
+/**
+ * These macros simplify operations to define jobs and resources, which are
+ * statically allocated and initialized. A statically defined job must be
+ * enabled by enable_job().
+ * mariOS_Job_Bind defines the interrupt handler of the job, e.g.
+ * mariOS_Job_Bind(my_job, EXTI0_IRQHandler).
+ */
+#define mariOS_Job_Define(job_name, job_handler, job_argument, irq, preemption_level) static mariOS_job job_name = \
+																	MARIOS_JOB_INITIALIZER(job_handler, job_argument, irq, preemption_level)
+#define mariOS_Job_Bind(job_name, vector_handler) void vector_handler(void) { mariOS_job_dispatch(&job_name); }
+#define mariOS_SRP_Resource_Define(resource_name, resource_ceiling) static mariOS_srp_resource resource_name = \
+																	MARIOS_SRP_RESOURCE_INITIALIZER(resource_ceiling)
+
+/**
+ * @brief The function initializes a job and enables its interrupt.
+ *
+ * @param [out] job is the job handler
+ * @param [in] handler is the function run each time the job is released
+ * @param [in] argument is the argument passed to the handler
+ * @param [in] irq_number is the unused interrupt the job is bound to
+ * @param [in] level is the preemption level, from 1 to ::MARIOS_SRP_MAX_LEVEL
+ * @return ::MARIOS_SRP_SUCCESS_OP or ::MARIOS_SRP_INVALID_LEVEL_OP
+ */
+mariOS_srp_op_status_t initJob(mariOS_job* job, mariOS_job_handler_t handler, void* argument, int32_t irq_number, uint8_t level);
+
+/**
+ * @brief The function enables the interrupt of a statically defined job.
+ *
+ * @param [in] job is the job handler
+ * @return ::MARIOS_SRP_SUCCESS_OP or ::MARIOS_SRP_INVALID_LEVEL_OP
+ */
+mariOS_srp_op_status_t enable_job(mariOS_job* job);
+
+/**
+ * @brief The release_job function releases a job, which preempts the caller
+ * if its preemption level is higher. Releases are counted, hence a job
+ * released n times runs n times. It can be invoked by tasks, interrupt
+ * handlers and jobs.
+ *
+ * @param [in,out] job is the job handler
+ * @retval None
+ */
+void release_job(mariOS_job* job);
+
+/**
+ * @brief The function serves the pending releases of a job. It is invoked by
+ * the interrupt handler defined by mariOS_Job_Bind.
+ *
+ * @param [in,out] job is the job handler
+ * @retval None
+ */
+void mariOS_job_dispatch(mariOS_job* job);
+
+/**
+ * @brief The function raises the ceiling of a resource to the preemption
+ * level of a job using it. It must be invoked for every job before they are
+ * released, unless the ceiling is set by mariOS_SRP_Resource_Define.
+ *
+ * @param [in,out] resource is the resource handler
+ * @param [in] job is a job that uses the resource
+ * @retval None
+ */
+void use_resource(mariOS_srp_resource* resource, mariOS_job* job);
+
+/**
+ * @brief The lock_resource function masks every job whose preemption level
+ * is not greater than the ceiling of the resource, until unlock_resource is
+ * invoked. Locks must be released in reverse order.
+ * The caller never waits: SRP guarantees that the resource is free.
+ *
+ * @param [in,out] resource is the resource handler
+ * @retval None
+ */
+void lock_resource(mariOS_srp_resource* resource);
+
+/**
+ * @brief See lock_resource.
+ *
+ * @param [in,out] resource is the resource handler
+ * @retval None
+ */
+void unlock_resource(mariOS_srp_resource* resource);
+
+#endif /* SRP_H_ */
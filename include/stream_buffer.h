@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	stream_buffer.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS stream buffers. A stream buffer carries a byte
+ * 			stream from a single writer (typically an interrupt handler or a DMA
+ * 			callback) to a single reader task, which is woken once enough bytes
+ * 			have been received rather than at each write.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef STREAM_BUFFER_H_
+#define STREAM_BUFFER_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This struct is used to typedef the mariOS stream buffer. It is a
+ * cyclic buffer whose head is only moved by the writer and whose tail is only
+ * moved by the reader, hence bytes are written and read without any critical
+ * section. One byte of the buffer is kept empty to tell a full buffer from an
+ * empty one.
+ * The reader waits until trigger_level bytes are available (or the timeout
+ * expires), and the writer wakes it only once that level is reached.
+ */
+typedef struct stream_buffer_t
+{
+	uint8_t* buffer;								/** the memory of the stream buffer */
+	uint32_t size;									/** the size of the memory */
+	volatile uint32_t head;							/** where the writer writes the next byte */
+	volatile uint32_t tail;							/** where the reader reads the next byte */
+	uint32_t trigger_level;							/** bytes that wake the reader up */
+	volatile mariOS_task_id_t reader;				/** the reader waiting for bytes, if any */
+	volatile uint32_t reader_level;					/** bytes the waiting reader needs */
+} mariOS_stream_buffer;
+
+/**
+ * This macro expands to the compile-time initializer of an empty ::mariOS_stream_buffer.
+ */
+#define MARIOS_STREAM_BUFFER_INITIALIZER(stream_memory, memory_size, level) { (stream_memory), (memory_size), 0, 0, (level), MARIOS_INVALID_TASK_ID, 0 }
+
+/**
+ * This macro expands to the trigger level clamped between 1 and the capacity,
+ * as initStreamBuffer() does.
+ */
+#define MARIOS_STREAM_TRIGGER_LEVEL(capacity, level) ((((level) < (capacity)) ? (level) : (capacity)) < 1 ? 1 : \
+													  (((level) < (capacity)) ? (level) : (capacity)))
+
+/**
+ * This macro simplifies operations to define a mariOS stream buffer able to
+ * hold capacity bytes, which is statically allocated along with its memory.
+ */
+#define mariOS_Stream_Buffer_Define(stream_name, capacity, level) static uint8_t stream_name##_memory[(capacity)+1]; \
+																	static mariOS_stream_buffer stream_name = \
+																	MARIOS_STREAM_BUFFER_INITIALIZER(stream_name##_memory, (capacity)+1, MARIOS_STREAM_TRIGGER_LEVEL(capacity, level))
+
+/**
+ * @brief The function initializes an empty stream buffer.
+ *
+ * @param [out] stream is the stream buffer handler
+ * @param [in] buffer is the memory of the stream buffer, whose capacity is size-1 bytes
+ * @param [in] size is the size of the memory
+ * @param [in] trigger_level is the number of bytes that wake the reader up, between 1 and the capacity
+ * @retval None
+ */
+void initStreamBuffer(mariOS_stream_buffer* stream, uint8_t* buffer, uint32_t size, uint32_t trigger_level);
+
+/**
+ * @brief The send_stream function writes up to size bytes into the stream
+ * buffer, without waiting. If the reader is waiting and enough bytes are now
+ * available, it is made ready and preempts the writer if it has a higher
+ * priority.
+ *
+ * @param [in,out] stream is the stream buffer handler
+ * @param [in] data is the pointer to the bytes to write
+ * @param [in] size is the number of bytes to write
+ * @return the number of bytes written, less than size if the buffer got full
+ */
+uint32_t send_stream(mariOS_stream_buffer* stream, const uint8_t* data, uint32_t size);
+
+/**
+ * @brief The send_stream_from_isr function is the send_stream that can be
+ * safely invoked by an interrupt handler (e.g., the half and full transfer
+ * callbacks of a DMA). It never calls the scheduler: if the reader made ready
+ * has a priority higher than the interrupted task,
+ * higher_priority_task_woken is set to 1, to be passed to
+ * mariOS_yield_from_isr() before returning from the ISR.
+ *
+ * @param [in,out] stream is the stream buffer handler
+ * @param [in] data is the pointer to the bytes to write
+ * @param [in] size is the number of bytes to write
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return the number of bytes written, less than size if the buffer got full
+ */
+uint32_t send_stream_from_isr(mariOS_stream_buffer* stream, const uint8_t* data, uint32_t size, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The receive_stream function waits until the trigger level (or
+ * max_size, if lower) is reached or timeout_ticks elapse, and then reads as
+ * many bytes as are available, up to max_size.
+ *
+ * @param [in,out] stream is the stream buffer handler
+ * @param [out] data is the pointer to the memory receiving the bytes
+ * @param [in] max_size is the size of data
+ * @param [in] timeout_ticks is the maximum number of ticks to wait: 0 does not wait,
+ * 			   ::MARIOS_WAIT_FOREVER waits until the trigger level is reached
+ * @return the number of bytes read, 0 if the timeout expired on an empty buffer
+ */
+uint32_t receive_stream(mariOS_stream_buffer* stream, uint8_t* data, uint32_t max_size, uint32_t timeout_ticks);
+
+/**
+ * @brief The function changes the trigger level of the stream buffer. It
+ * takes effect from the next receive_stream.
+ *
+ * @param [in,out] stream is the stream buffer handler
+ * @param [in] trigger_level is the number of bytes that wake the reader up, between 1 and the capacity
+ * @retval None
+ */
+void set_stream_trigger_level(mariOS_stream_buffer* stream, uint32_t trigger_level);
+
+/**
+ * @brief The function returns the number of bytes that can be read.
+ *
+ * @param [in] stream is the stream buffer handler
+ * @return the number of available bytes
+ */
+uint32_t get_stream_available(mariOS_stream_buffer* stream);
+
+#endif /* STREAM_BUFFER_H_ */
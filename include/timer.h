@@ -0,0 +1,166 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	timer.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS software timers. Timers invoke a callback once or
+ * 			periodically, sharing the stack of a single timer daemon task (or the
+ * 			tick handler) instead of requiring a task each.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This is the type of the function invoked when a timer expires.
+ */
+typedef void (*mariOS_timer_callback_t)(void const* argument);
+
+/**
+ * @brief This enum lists the kinds of timer.
+ */
+typedef enum
+{
+	MARIOS_TIMER_ONE_SHOT,			/**< The timer expires once and then stops					*/
+	MARIOS_TIMER_PERIODIC			/**< The timer expires every period until it is stopped		*/
+} mariOS_timer_type_t;
+
+/**
+ * @brief This enum lists the possible outcomes of timer operations.
+ * ::MARIOS_TIMER_SUCCESS_OP indicates a success operation
+ * ::MARIOS_TIMER_INVALID_OP indicates a period equal to 0 or that timers are
+ * disabled (see ::MARIOS_CONFIG_TIMERS), while
+ * ::MARIOS_TIMER_STOPPED_OP indicates that the timer was not running.
+ */
+typedef enum
+{
+	MARIOS_TIMER_SUCCESS_OP,		/**< Timer operation successfully completes					*/
+	MARIOS_TIMER_INVALID_OP,		/**< The period is not valid, or timers are disabled		*/
+	MARIOS_TIMER_STOPPED_OP			/**< The timer was not running								*/
+} mariOS_timer_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS software timer.
+ * Running timers are kept by a timer wheel of ::MARIOS_CONFIG_TIMER_WHEEL_SIZE
+ * slots: a timer is linked to the slot indexed by its expiration tick modulo
+ * the size of the wheel, hence it is started and stopped in constant time,
+ * and each tick only the timers of one slot are checked.
+ * Timers whose period is longer than the wheel stay in their slot for more
+ * than one revolution.
+ * Timers can only be started if ::MARIOS_CONFIG_TIMERS is set.
+ */
+typedef struct software_timer_t
+{
+	mariOS_timer_callback_t callback;		/** function invoked when the timer expires */
+	void const* argument;					/** argument passed to the callback */
+	mariOS_timer_type_t type;				/** one-shot or periodic */
+	uint32_t period;						/** period of the timer in ticks */
+	uint32_t expiration;					/** tick of the next expiration */
+	volatile uint8_t running;				/** 1 if the timer is linked to the wheel */
+	struct software_timer_t* next;			/** next timer of the same slot */
+	struct software_timer_t* prev;			/** previous timer of the same slot */
+} mariOS_timer;
+
+/**
+ * This macro expands to the compile-time initializer of a stopped ::mariOS_timer.
+ */
+#define MARIOS_TIMER_INITIALIZER(timer_callback, timer_argument, timer_type) { (timer_callback), (timer_argument), (timer_type), 0, 0, 0, NULL, NULL }
+
+/**
+ * This macro simplifies operations to define a mariOS software timer, which
+ * is statically allocated and initialized.
+ */
+#define mariOS_Timer_Define(timer_name, timer_callback, timer_argument, timer_type) static mariOS_timer timer_name = \
+																			MARIOS_TIMER_INITIALIZER(timer_callback, timer_argument, timer_type)
+
+/**
+ * @brief The function initializes a stopped timer.
+ *
+ * @param [out] timer is the timer handler
+ * @param [in] callback is the function invoked when the timer expires
+ * @param [in] argument is the argument passed to the callback
+ * @param [in] type tells whether the timer is one-shot or periodic
+ * @retval None
+ */
+void initTimer(mariOS_timer* timer, mariOS_timer_callback_t callback, void const* argument, mariOS_timer_type_t type);
+
+/**
+ * @brief The start_timer function (re)starts a timer, which expires
+ * period_ticks ticks later. A periodic timer is rescheduled from its previous
+ * expiration tick rather than from the time its callback runs, hence it does
+ * not drift even if callbacks are delayed.
+ * The callback runs inside the timer daemon task, or inside the tick handler
+ * when ::MARIOS_CONFIG_TIMER_DAEMON is 0. It can be invoked by interrupt
+ * handlers. If ::MARIOS_CONFIG_TIMERS is 0 the timer is not started, since
+ * it would never expire, and ::MARIOS_TIMER_INVALID_OP is returned.
+ *
+ * @param [in,out] timer is the timer handler
+ * @param [in] period_ticks is the period of the timer in ticks, greater than 0
+ * @return ::MARIOS_TIMER_SUCCESS_OP or ::MARIOS_TIMER_INVALID_OP
+ */
+mariOS_timer_op_status_t start_timer(mariOS_timer* timer, uint32_t period_ticks);
+
+/**
+ * @brief The stop_timer function stops a running timer. It can be invoked by
+ * interrupt handlers.
+ *
+ * @param [in,out] timer is the timer handler
+ * @return ::MARIOS_TIMER_SUCCESS_OP or ::MARIOS_TIMER_STOPPED_OP
+ */
+mariOS_timer_op_status_t stop_timer(mariOS_timer* timer);
+
+/**
+ * @brief The function tells whether a timer is running.
+ *
+ * @param [in] timer is the timer handler
+ * @return 1 if the timer is running, 0 otherwise
+ */
+uint8_t is_timer_running(mariOS_timer* timer);
+
+/**
+ * @brief The function initializes the timer service and, if
+ * ::MARIOS_CONFIG_TIMER_DAEMON is 1, creates the timer daemon task.
+ * It is invoked by mariOS_init().
+ *
+ * @param  None
+ * @retval None
+ */
+void mariOS_timer_init(void);
+
+/**
+ * @brief The function advances the timer service by one tick: it runs the
+ * expired callbacks or wakes the timer daemon up. It is invoked by the
+ * systick handler.
+ *
+ * @param  None
+ * @retval None
+ */
+void mariOS_timer_tick(void);
+
+#endif /* TIMER_H_ */
@@ -0,0 +1,158 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	trace.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of the mariOS kernel trace. When MARIOS_CONFIG_TRACE is 1,
+ * 			the kernel records fixed-size binary events into a RAM ring buffer,
+ * 			which can be dumped and decoded by tools/trace_decode.py.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <mariOS_config.h>
+#include <inttypes.h>
+
+/**
+ * @brief This enum lists the kinds of traced events. The meaning of the task
+ * and data fields of ::mariOS_trace_event depends on the kind.
+ */
+typedef enum
+{
+	MARIOS_TRACE_SCHEDULE = 1,		/**< The scheduler picked task; data is the previous task		*/
+	MARIOS_TRACE_SWITCH,			/**< PendSV switched the context to task						*/
+	MARIOS_TRACE_STATUS,			/**< The status of task changed; data is the new status			*/
+	MARIOS_TRACE_WAKEUP,			/**< The systick woke task up; data is 1 if a timeout expired		*/
+	MARIOS_TRACE_QUEUE_SEND,		/**< task enqueued; data is the size of the message				*/
+	MARIOS_TRACE_QUEUE_RECEIVE,		/**< task dequeued; data is the size of the message				*/
+	MARIOS_TRACE_QUEUE_BLOCK,		/**< task blocked on a queue; data is 0 to send, 1 to receive	*/
+	MARIOS_TRACE_ISR_ENTER,			/**< An interrupt handler started; data is the exception number	*/
+	MARIOS_TRACE_ISR_EXIT,			/**< An interrupt handler completed; data is the exception number	*/
+	MARIOS_TRACE_TICK,				/**< The systick handler ran; data is the low half of the ticks	*/
+	MARIOS_TRACE_USER				/**< Event recorded by the application							*/
+} mariOS_trace_event_type_t;
+
+/**
+ * @brief This struct is a traced event. Its size is fixed to 8 bytes, hence
+ * recording an event costs a few stores, and the ring buffer can be decoded
+ * without any framing.
+ */
+typedef struct trace_event_t
+{
+	uint32_t timestamp;						/** cycle counter when the event occurred */
+	uint8_t type;							/** the ::mariOS_trace_event_type_t of the event */
+	uint8_t task;							/** the task the event refers to */
+	uint16_t data;							/** event-specific data */
+} mariOS_trace_event;
+
+/**
+ * The magic number at the beginning of the trace, which lets the decoder
+ * find it and check the byte order of a memory dump.
+ */
+#define MARIOS_TRACE_MAGIC 0x6D4F5354 /* "mOST" */
+
+/**
+ * @brief This struct is the trace: a header followed by the ring buffer of
+ * ::MARIOS_CONFIG_TRACE_EVENTS events. The index counts every event recorded
+ * so far: the oldest event still available is at index modulo the size of
+ * the buffer once it has wrapped around.
+ */
+typedef struct trace_t
+{
+	uint32_t magic;							/** ::MARIOS_TRACE_MAGIC */
+	uint32_t size;							/** number of events of the ring buffer */
+	uint32_t cycles_per_tick;				/** cycles between two systick interrupts */
+	volatile uint32_t index;				/** number of events recorded so far */
+	volatile uint32_t enabled;				/** 0 freezes the trace, e.g. once a deadline is missed */
+	mariOS_trace_event events[MARIOS_CONFIG_TRACE_EVENTS];
+} mariOS_trace;
+
+#if MARIOS_CONFIG_TRACE
+
+extern mariOS_trace mariOS_trace_buffer;
+
+/**
+ * This macro records an event; it expands to nothing when the trace is disabled.
+ */
+#define MARIOS_TRACE(type, task, data) mariOS_trace_record((type), (task), (data))
+
+/**
+ * @brief The function records an event into the ring buffer, without any lock:
+ * a slot is reserved by an exclusive update of the index, hence tasks and
+ * nested interrupt handlers can record events concurrently.
+ *
+ * @param [in] type is the ::mariOS_trace_event_type_t of the event
+ * @param [in] task is the task the event refers to
+ * @param [in] data is the event-specific data
+ * @retval None
+ */
+void mariOS_trace_record(uint8_t type, uint8_t task, uint16_t data);
+
+/**
+ * @brief The function records the context switch performed by PendSV_Handler().
+ *
+ * @param  None
+ * @retval None
+ */
+void mariOS_trace_context_switch(void);
+
+/**
+ * @brief The functions record the entry and the exit of an interrupt handler.
+ * They are to be called at the beginning and at the end of the handlers that
+ * should appear into the trace.
+ *
+ * @param  None
+ * @retval None
+ */
+void mariOS_trace_isr_enter(void);
+void mariOS_trace_isr_exit(void);
+
+/**
+ * @brief The function initializes the trace and enables it.
+ *
+ * @param [in] cycles_per_tick is the number of cycles between two systick
+ * 			   interrupts, which lets the decoder convert timestamps
+ * @retval None
+ */
+void mariOS_trace_init(uint32_t cycles_per_tick);
+
+/**
+ * @brief The functions freeze and resume the trace, e.g., to dump it.
+ *
+ * @param  None
+ * @retval None
+ */
+void mariOS_trace_stop(void);
+void mariOS_trace_start(void);
+
+#else
+
+#define MARIOS_TRACE(type, task, data) ((void)0)
+
+#endif /* MARIOS_CONFIG_TRACE */
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	work_queue.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Header file of mariOS work queues. A work queue is a task that runs, in
+ * 			FIFO order, the work items submitted by interrupt handlers (or tasks),
+ * 			so that long processing is deferred out of interrupt context and runs
+ * 			at the priority of the queue.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef WORK_QUEUE_H_
+#define WORK_QUEUE_H_
+
+#include <mariOS_config.h>
+#include "mariOS.h"
+
+/**
+ * @brief This is the type of the function run by a work item.
+ */
+typedef void (*mariOS_work_handler_t)(void* context);
+
+/**
+ * @brief This enum lists the possible outcomes of work queue operations.
+ * ::MARIOS_WORK_SUCCESS_OP indicates a success operation
+ * ::MARIOS_WORK_PENDING_OP indicates that the item was already pending, hence
+ * the submission has been coalesced with the previous one, while
+ * ::MARIOS_WORK_NO_TASK_OP indicates that the task of the queue cannot be created.
+ */
+typedef enum
+{
+	MARIOS_WORK_SUCCESS_OP,			/**< Work queue operation successfully completes			*/
+	MARIOS_WORK_PENDING_OP,			/**< The item is already pending and runs once				*/
+	MARIOS_WORK_NO_TASK_OP			/**< The task of the work queue cannot be created			*/
+} mariOS_work_op_status_t;
+
+/**
+ * @brief This struct is used to typedef the mariOS work item. Items are
+ * allocated by the application, hence submitting one never allocates memory.
+ * An item is pending from its submission until its handler starts, and it
+ * can be submitted again as soon as the handler starts.
+ */
+typedef struct work_item_t
+{
+	mariOS_work_handler_t handler;			/** function run by the item */
+	void* context;							/** argument passed to the handler */
+	volatile uint8_t pending;				/** 1 from the submission until the handler starts */
+	uint32_t submit_cycles;					/** cycle counter at the submission */
+	struct work_item_t* next;				/** next pending item of the same queue */
+} mariOS_work_item;
+
+/**
+ * @brief This struct is used to typedef the mariOS work queue. Each queue
+ * owns a task, hence queues with different priorities act as priority lanes
+ * for deferred work.
+ * The latency of an item is measured in CPU cycles from its submission to
+ * the start of its handler.
+ */
+typedef struct work_queue_t
+{
+	mariOS_task_id_t task;					/** the task running the items */
+	mariOS_work_item* head;					/** the first pending item */
+	mariOS_work_item* tail;					/** the last pending item */
+	uint32_t last_latency;					/** latency of the last item, in cycles */
+	uint32_t max_latency;					/** maximum latency observed, in cycles */
+} mariOS_work_queue;
+
+/**
+ * These macros expand to the compile-time initializers of work items and queues.
+ */
+#define MARIOS_WORK_ITEM_INITIALIZER(work_handler, work_context) { (work_handler), (work_context), 0, 0, NULL }
+#define MARIOS_WORK_QUEUE_INITIALIZER { MARIOS_INVALID_TASK_ID, NULL, NULL, 0, 0 }
+
+/**
+ * These macros simplify operations to define work items and work queues,
+ * which are statically allocated. A work queue must be started by
+ * initWorkQueue().
+ */
+#define mariOS_Work_Item_Define(item_name, work_handler, work_context) static mariOS_work_item item_name = \
+																		MARIOS_WORK_ITEM_INITIALIZER(work_handler, work_context)
+#define mariOS_Work_Queue_Define(queue_name, stack_size) static mariOS_stack_t queue_name##_stack[stack_size] __attribute__ ((aligned (4))); \
+														 static mariOS_work_queue queue_name = MARIOS_WORK_QUEUE_INITIALIZER
+
+/**
+ * @brief The function initializes a work queue and creates its task.
+ *
+ * @param [out] work_queue is the work queue handler
+ * @param [in] priority is the priority of the task of the queue
+ * @param [in] stack_ptr is the stack of the task of the queue
+ * @param [in] stack_size is the size of the stack
+ * @return ::MARIOS_WORK_SUCCESS_OP or ::MARIOS_WORK_NO_TASK_OP
+ */
+mariOS_work_op_status_t initWorkQueue(mariOS_work_queue* work_queue, mariOS_priority priority, mariOS_stack_t* stack_ptr, uint32_t stack_size);
+
+/**
+ * @brief The function initializes a work item.
+ *
+ * @param [out] item is the work item handler
+ * @param [in] handler is the function run by the item
+ * @param [in] context is the argument passed to the handler
+ * @retval None
+ */
+void initWorkItem(mariOS_work_item* item, mariOS_work_handler_t handler, void* context);
+
+/**
+ * @brief The submit_work function appends an item to a work queue and wakes
+ * its task up, which preempts the caller if it has a higher priority.
+ * Submitting an item that is still pending has no effect.
+ *
+ * @param [in,out] work_queue is the work queue handler
+ * @param [in,out] item is the work item handler
+ * @return ::MARIOS_WORK_SUCCESS_OP or ::MARIOS_WORK_PENDING_OP
+ */
+mariOS_work_op_status_t submit_work(mariOS_work_queue* work_queue, mariOS_work_item* item);
+
+/**
+ * @brief The submit_work_from_isr function is the submit_work that can be
+ * safely invoked by an interrupt handler. It never calls the scheduler: if the
+ * task of the queue has a priority higher than the interrupted one,
+ * higher_priority_task_woken is set to 1, to be passed to
+ * mariOS_yield_from_isr() before returning from the ISR.
+ *
+ * @param [in,out] work_queue is the work queue handler
+ * @param [in,out] item is the work item handler
+ * @param [out] higher_priority_task_woken is set to 1 if a task with higher priority
+ * 				has been woken; it can be NULL
+ * @return ::MARIOS_WORK_SUCCESS_OP or ::MARIOS_WORK_PENDING_OP
+ */
+mariOS_work_op_status_t submit_work_from_isr(mariOS_work_queue* work_queue, mariOS_work_item* item, uint8_t* higher_priority_task_woken);
+
+/**
+ * @brief The functions return the latency of the last item run by the queue
+ * and the maximum latency observed, in CPU cycles.
+ *
+ * @param [in] work_queue is the work queue handler
+ * @return the latency in cycles
+ */
+uint32_t get_work_queue_last_latency(mariOS_work_queue* work_queue);
+uint32_t get_work_queue_max_latency(mariOS_work_queue* work_queue);
+
+#endif /* WORK_QUEUE_H_ */
@@ -1,4 +1,13 @@
 #include "cmsis_os.h"
+#include "event_flags.h"
+
+/**
+ * mariOS task IDs are handed out to CMSIS as thread IDs: since the idle
+ * task takes the ID 0, a valid thread ID is never NULL.
+ */
+#define THREAD_ID(task_id)		((osThreadId)(uintptr_t)(task_id))
+#define TASK_ID(thread_id)		((mariOS_task_id_t)(uintptr_t)(thread_id))
+#define IS_VALID_THREAD_ID(thread_id)	(NULL != (thread_id) && (uintptr_t)(thread_id) < MARIOS_CONFIG_MAX_TASKS)
 
 osStatus osKernelInitialize (void){
 	mariOS_init();
@@ -17,13 +26,17 @@ uint32_t osKernelSysTick(void)
 
 osThreadId osThreadCreate (const osThreadDef_t *thread_def, void *argument)
 {
-	return mariOS_task_init(thread_def->pthread, thread_def->stack_ptr, thread_def->stacksize, thread_def->priority, thread_def->period);
-  
+	mariOS_task_id_t task_id = mariOS_task_init(thread_def->pthread, thread_def->stack_ptr, thread_def->stacksize, thread_def->priority, thread_def->period);
+	if(MARIOS_INVALID_TASK_ID == task_id)
+		return NULL;
+	return THREAD_ID(task_id);
 }
 
 osThreadId osThreadGetId (void)
 {
-	return NULL;
+	if(is_isr_context())
+		return NULL;
+	return THREAD_ID(get_current_task_id());
 }
 
 osStatus osThreadTerminate (osThreadId thread_id)
@@ -54,3 +67,277 @@ osStatus osDelay (uint32_t millisec)
 	return osOK;
 }
 
+osTimerId osTimerCreate (const osTimerDef_t *timer_def, os_timer_type type, void *argument)
+{
+	if(NULL == timer_def || NULL == timer_def->control_block || NULL == timer_def->ptimer)
+		return NULL;
+	initTimer(timer_def->control_block, timer_def->ptimer, argument,
+			  (osTimerPeriodic == type) ? MARIOS_TIMER_PERIODIC : MARIOS_TIMER_ONE_SHOT);
+	return timer_def->control_block;
+}
+
+osStatus osTimerStart (osTimerId timer_id, uint32_t millisec)
+{
+	if(NULL == timer_id)
+		return osErrorParameter;
+#if !MARIOS_CONFIG_TIMERS
+	(void)millisec;
+	return osErrorResource; //Timers are disabled, hence the timer would never expire
+#else
+	if(MARIOS_TIMER_SUCCESS_OP != start_timer(timer_id, MARIOS_MS_TO_TICKS(millisec)))
+		return osErrorValue;
+	return osOK;
+#endif
+}
+
+osStatus osTimerStop (osTimerId timer_id)
+{
+	if(NULL == timer_id)
+		return osErrorParameter;
+	if(MARIOS_TIMER_SUCCESS_OP != stop_timer(timer_id))
+		return osErrorResource;
+	return osOK;
+}
+
+osStatus osTimerDelete (osTimerId timer_id)
+{
+	if(NULL == timer_id)
+		return osErrorParameter;
+	if(is_isr_context())
+		return osErrorISR;
+	stop_timer(timer_id);
+	return osOK;
+}
+
+int32_t osSignalSet (osThreadId thread_id, int32_t signals)
+{
+	if(!IS_VALID_THREAD_ID(thread_id) || signals < 0)
+		return 0x80000000;
+	if(is_isr_context())
+	{
+		uint8_t higher_priority_task_woken = 0;
+		int32_t previous = set_task_signals_from_isr(TASK_ID(thread_id), signals, &higher_priority_task_woken);
+		mariOS_yield_from_isr(higher_priority_task_woken);
+		return previous;
+	}
+	return set_task_signals(TASK_ID(thread_id), signals);
+}
+
+int32_t osSignalClear (osThreadId thread_id, int32_t signals)
+{
+	if(!IS_VALID_THREAD_ID(thread_id) || signals < 0 || is_isr_context())
+		return 0x80000000;
+	return clear_task_signals(TASK_ID(thread_id), signals);
+}
+
+osEvent osSignalWait (int32_t signals, uint32_t millisec)
+{
+	osEvent event;
+	uint32_t received;
+	if(signals < 0)
+	{
+		event.status = osErrorValue;
+		return event;
+	}
+	if(is_isr_context())
+	{
+		event.status = osErrorISR;
+		return event;
+	}
+	/* signals equal to 0 means any flag, otherwise all of them are required */
+	if(MARIOS_SIGNALS_SUCCESS_OP == wait_signals(signals, MARIOS_SIGNALS_WAIT_ALL, MARIOS_MS_TO_TICKS(millisec), &received))
+	{
+		event.status = osEventSignal;
+		event.value.signals = received;
+	}
+	else
+		event.status = (0 == millisec) ? osOK : osEventTimeout;
+	return event;
+}
+
+osMutexId osMutexCreate (const osMutexDef_t *mutex_def)
+{
+	if(NULL == mutex_def || NULL == mutex_def->mutex)
+		return NULL;
+	initMutex(mutex_def->mutex);
+	return mutex_def->mutex;
+}
+
+osStatus osMutexWait (osMutexId mutex_id, uint32_t millisec)
+{
+	if(NULL == mutex_id)
+		return osErrorParameter;
+	if(is_isr_context())
+		return osErrorISR;
+	if(MARIOS_MUTEX_SUCCESS_OP == lock_mutex(mutex_id, MARIOS_MS_TO_TICKS(millisec)))
+		return osOK;
+	return (0 == millisec) ? osErrorResource : osErrorTimeoutResource;
+}
+
+osStatus osMutexRelease (osMutexId mutex_id)
+{
+	if(NULL == mutex_id)
+		return osErrorParameter;
+	if(is_isr_context())
+		return osErrorISR;
+	if(MARIOS_MUTEX_SUCCESS_OP != unlock_mutex(mutex_id))
+		return osErrorResource;
+	return osOK;
+}
+
+osStatus osMutexDelete (osMutexId mutex_id)
+{
+	if(NULL == mutex_id)
+		return osErrorParameter;
+	if(is_isr_context())
+		return osErrorISR;
+	if(MARIOS_INVALID_TASK_ID != mutex_id->owner) //An owned mutex cannot be deleted
+		return osErrorResource;
+	return osOK;
+}
+
+osSemaphoreId osSemaphoreCreate (const osSemaphoreDef_t *semaphore_def, int32_t count)
+{
+	if(NULL == semaphore_def || NULL == semaphore_def->semaphore || count < 0 || count > osFeature_Semaphore)
+		return NULL;
+	initSemaphore(semaphore_def->semaphore, count, osFeature_Semaphore);
+	return semaphore_def->semaphore;
+}
+
+int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec)
+{
+	if(NULL == semaphore_id)
+		return -1;
+	if(is_isr_context() && 0 != millisec) //An interrupt handler cannot wait
+		return -1;
+	if(MARIOS_SEMAPHORE_SUCCESS_OP != take_semaphore(semaphore_id, MARIOS_MS_TO_TICKS(millisec)))
+		return 0;
+	return get_semaphore_count(semaphore_id)+1; //Tokens available when the wait succeeded
+}
+
+osStatus osSemaphoreRelease (osSemaphoreId semaphore_id)
+{
+	mariOS_semaphore_op_status_t status;
+	if(NULL == semaphore_id)
+		return osErrorParameter;
+	if(is_isr_context())
+	{
+		uint8_t higher_priority_task_woken = 0;
+		status = give_semaphore_from_isr(semaphore_id, &higher_priority_task_woken);
+		mariOS_yield_from_isr(higher_priority_task_woken);
+	}
+	else
+		status = give_semaphore(semaphore_id);
+	return (MARIOS_SEMAPHORE_SUCCESS_OP == status) ? osOK : osErrorResource;
+}
+
+osStatus osSemaphoreDelete (osSemaphoreId semaphore_id)
+{
+	if(NULL == semaphore_id)
+		return osErrorParameter;
+	if(is_isr_context())
+		return osErrorISR;
+	if(semaphore_id->count < 0) //A semaphore cannot be deleted while tasks are waiting for it
+		return osErrorResource;
+	return osOK;
+}
+
+osPoolId osPoolCreate (const osPoolDef_t *pool_def)
+{
+	if(NULL == pool_def || NULL == pool_def->control_block || NULL == pool_def->pool || 0 == pool_def->pool_sz)
+		return NULL;
+	initPool(pool_def->control_block, (uint32_t*)pool_def->pool, pool_def->item_sz, pool_def->pool_sz);
+	return pool_def->control_block;
+}
+
+void *osPoolAlloc (osPoolId pool_id)
+{
+	if(NULL == pool_id)
+		return NULL;
+	return allocate_block(pool_id);
+}
+
+void *osPoolCAlloc (osPoolId pool_id)
+{
+	if(NULL == pool_id)
+		return NULL;
+	return allocate_zeroed_block(pool_id);
+}
+
+osStatus osPoolFree (osPoolId pool_id, void *block)
+{
+	if(NULL == pool_id || NULL == block)
+		return osErrorParameter;
+	return (MARIOS_POOL_SUCCESS_OP == free_block(pool_id, block)) ? osOK : osErrorValue;
+}
+
+osMailQId osMailCreate (const osMailQDef_t *queue_def, osThreadId thread_id)
+{
+	(void)thread_id;
+	if(NULL == queue_def || NULL == queue_def->control_block || 0 == queue_def->queue_sz)
+		return NULL;
+	initMailQueue(queue_def->control_block, (uint32_t*)queue_def->pool, queue_def->slots, queue_def->item_sz, queue_def->queue_sz);
+	return queue_def->control_block;
+}
+
+void *osMailAlloc (osMailQId queue_id, uint32_t millisec)
+{
+	if(NULL == queue_id || (is_isr_context() && 0 != millisec)) //An interrupt handler cannot wait
+		return NULL;
+	return allocate_mail(queue_id, MARIOS_MS_TO_TICKS(millisec));
+}
+
+void *osMailCAlloc (osMailQId queue_id, uint32_t millisec)
+{
+	if(NULL == queue_id || (is_isr_context() && 0 != millisec))
+		return NULL;
+	return allocate_zeroed_mail(queue_id, MARIOS_MS_TO_TICKS(millisec));
+}
+
+osStatus osMailPut (osMailQId queue_id, void *mail)
+{
+	mariOS_mail_op_status_t status;
+	if(NULL == queue_id || NULL == mail)
+		return osErrorParameter;
+	if(is_isr_context())
+	{
+		uint8_t higher_priority_task_woken = 0;
+		status = put_mail_from_isr(queue_id, mail, &higher_priority_task_woken);
+		mariOS_yield_from_isr(higher_priority_task_woken);
+	}
+	else
+		status = put_mail(queue_id, mail);
+	return (MARIOS_MAIL_SUCCESS_OP == status) ? osOK : osErrorValue;
+}
+
+osEvent osMailGet (osMailQId queue_id, uint32_t millisec)
+{
+	osEvent event;
+	event.def.mail_id = queue_id;
+	event.value.p = NULL;
+	if(NULL == queue_id)
+		event.status = osErrorParameter;
+	else if(is_isr_context() && 0 != millisec)
+		event.status = osErrorParameter;
+	else if(MARIOS_MAIL_SUCCESS_OP == get_mail(queue_id, MARIOS_MS_TO_TICKS(millisec), &event.value.p))
+		event.status = osEventMail;
+	else
+		event.status = (0 == millisec) ? osOK : osEventTimeout;
+	return event;
+}
+
+osStatus osMailFree (osMailQId queue_id, void *mail)
+{
+	mariOS_mail_op_status_t status;
+	if(NULL == queue_id || NULL == mail)
+		return osErrorParameter;
+	if(is_isr_context())
+	{
+		uint8_t higher_priority_task_woken = 0;
+		status = free_mail_from_isr(queue_id, mail, &higher_priority_task_woken);
+		mariOS_yield_from_isr(higher_priority_task_woken);
+	}
+	else
+		status = free_mail(queue_id, mail);
+	return (MARIOS_MAIL_SUCCESS_OP == status) ? osOK : osErrorValue;
+}
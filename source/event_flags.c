@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	event_flags.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS event flags. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "event_flags.h"
+
+/**
+ * The function returns the flags that satisfy a wait condition, or 0 if the
+ * condition is not met.
+ */
+static uint32_t matching_signals(uint32_t signals, uint32_t mask, mariOS_signals_wait_t mode)
+{
+	if(0 == mask) //Any flag is fine
+		return signals;
+	if(MARIOS_SIGNALS_WAIT_ALL == mode)
+		return ((signals & mask) == mask) ? mask : 0;
+	return signals & mask;
+}
+
+/**
+ * The function sets the flags of a task and resumes it if its wait condition
+ * is met. It must be invoked inside a critical section and it returns 1 if the
+ * task made ready has a priority higher than the current active task.
+ */
+static uint8_t signal_task(mariOS_task_id_t task_id, uint32_t signals, uint32_t* previous)
+{
+	mariOS_task_control_block_t* task = get_task_control_block(task_id);
+	*previous = task->signals;
+	task->signals |= signals;
+	if(MARIOS_SIGNALS_NOT_WAITING != task->signals_wait &&
+	   0 != matching_signals(task->signals, task->signals_wait_mask, task->signals_wait))
+	{
+		task->signals_wait = MARIOS_SIGNALS_NOT_WAITING;
+		set_task_status(task_id, MARIOS_TASK_STATUS_READY);
+		return task->priority > get_task_priority(get_current_task_id());
+	}
+	return 0;
+}
+
+uint32_t set_task_signals(mariOS_task_id_t task_id, uint32_t signals)
+{
+	uint32_t previous;
+	enter_critical_section();
+	{
+		if(signal_task(task_id, signals, &previous))
+			mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+								  *	 It will eventually have effect once the critical section ends.
+								  */
+	}
+	exit_critical_sction();
+	return previous;
+}
+
+uint32_t set_task_signals_from_isr(mariOS_task_id_t task_id, uint32_t signals, uint8_t* higher_priority_task_woken)
+{
+	uint32_t previous;
+	enter_critical_section(); //The ISR can be preempted by another one with higher priority
+	{
+		if(signal_task(task_id, signals, &previous) && NULL != higher_priority_task_woken)
+			*higher_priority_task_woken = 1;
+	}
+	exit_critical_sction();
+	return previous;
+}
+
+uint32_t clear_task_signals(mariOS_task_id_t task_id, uint32_t signals)
+{
+	uint32_t previous;
+	mariOS_task_control_block_t* task = get_task_control_block(task_id);
+	enter_critical_section();
+	{
+		previous = task->signals;
+		task->signals &= ~signals;
+	}
+	exit_critical_sction();
+	return previous;
+}
+
+mariOS_signals_op_status_t wait_signals(uint32_t signals, mariOS_signals_wait_t mode, uint32_t timeout_ticks, uint32_t* received)
+{
+	mariOS_task_control_block_t* task = get_task_control_block(get_current_task_id());
+	uint32_t matching;
+	enter_critical_section();
+	{
+		matching = matching_signals(task->signals, signals, mode);
+		if(0 == matching && 0 != timeout_ticks)
+		{
+			task->signals_wait_mask = signals;
+			task->signals_wait = mode;
+			mariOS_suspend_current_task(timeout_ticks);
+			exit_critical_sction(); //Here the context switch occurs
+
+			enter_critical_section();
+			task->signals_wait = MARIOS_SIGNALS_NOT_WAITING;
+			matching = matching_signals(task->signals, signals, mode);
+		}
+		task->signals &= ~matching; //Received flags are automatically cleared
+	}
+	exit_critical_sction();
+	if(NULL != received)
+		*received = matching;
+	return (0 != matching) ? MARIOS_SIGNALS_SUCCESS_OP : MARIOS_SIGNALS_TIMEOUT_OP;
+}
@@ -0,0 +1,379 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	heap.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS heaps. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stddef.h>
+#include "heap.h"
+
+/**
+ * Header of every block. The links to the free list are only meaningful
+ * while the block is free, hence they are overwritten by the user data of
+ * allocated blocks. The size is a multiple of ::MARIOS_HEAP_ALIGN, so that
+ * its least significant bit tells whether the block is free.
+ */
+typedef struct heap_block_t
+{
+	struct heap_block_t* prev_physical;		/** block preceding this one in memory, NULL for the first one */
+	uint32_t size;							/** bytes of user data, or'ed with HEAP_BLOCK_FREE */
+	struct heap_block_t* next_free;			/** next block into the same free list */
+	struct heap_block_t* prev_free;			/** previous block into the same free list */
+} heap_block;
+
+#define HEAP_BLOCK_FREE			1U
+#define HEAP_HEADER_SIZE		HEAP_ALIGN_UP(offsetof(heap_block, next_free))
+#define HEAP_MIN_BLOCK			HEAP_ALIGN_UP(sizeof(heap_block) - offsetof(heap_block, next_free))
+#define HEAP_MAX_BLOCK			((1UL << MARIOS_CONFIG_HEAP_MAX_BLOCK_LOG2) - MARIOS_HEAP_ALIGN)
+#define HEAP_ALIGN_UP(size)		(((size) + MARIOS_HEAP_ALIGN - 1) & ~(uintptr_t)(MARIOS_HEAP_ALIGN - 1))
+
+#define BLOCK_SIZE(block)		((block)->size & ~HEAP_BLOCK_FREE)
+#define BLOCK_IS_FREE(block)	((block)->size & HEAP_BLOCK_FREE)
+#define BLOCK_DATA(block)		((void*)((uint8_t*)(block) + HEAP_HEADER_SIZE))
+#define DATA_BLOCK(data)		((heap_block*)((uint8_t*)(data) - HEAP_HEADER_SIZE))
+#define BLOCK_NEXT(block)		((heap_block*)((uint8_t*)(block) + HEAP_HEADER_SIZE + BLOCK_SIZE(block)))
+
+/**
+ * Heaps searched by mariOS_free().
+ */
+static mariOS_heap* mariOS_heaps = NULL;
+
+#if MARIOS_CONFIG_HEAP_SIZE
+mariOS_heap mariOS_kernel_heap;
+static uint64_t mariOS_kernel_heap_region[(MARIOS_CONFIG_HEAP_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+#endif
+
+/**
+ * The function returns the index of the most significant bit set.
+ */
+static inline int heap_fls(uint32_t value)
+{
+	return 31 - __builtin_clz(value);
+}
+
+/**
+ * The function returns the index of the least significant bit set.
+ */
+static inline int heap_ffs(uint32_t value)
+{
+	return __builtin_ctz(value);
+}
+
+/**
+ * The function computes the list a free block of the given size belongs to.
+ */
+static void heap_mapping(uint32_t size, int* fl, int* sl)
+{
+	if(size < MARIOS_HEAP_SMALL_BLOCK)
+	{
+		*fl = 0;
+		*sl = size / (MARIOS_HEAP_SMALL_BLOCK / MARIOS_HEAP_SL_COUNT);
+	}
+	else
+	{
+		int msb = heap_fls(size);
+		*sl = (size >> (msb - MARIOS_HEAP_SL_LOG2)) ^ MARIOS_HEAP_SL_COUNT;
+		*fl = msb - MARIOS_HEAP_FL_SHIFT + 1;
+	}
+}
+
+/**
+ * The function computes the first list whose blocks all fit the given size,
+ * rounding the size up to the next list boundary.
+ */
+static void heap_mapping_search(uint32_t size, int* fl, int* sl)
+{
+	if(size >= MARIOS_HEAP_SMALL_BLOCK)
+		size += (1U << (heap_fls(size) - MARIOS_HEAP_SL_LOG2)) - 1;
+	heap_mapping(size, fl, sl);
+}
+
+/**
+ * The function computes the largest request that a free block of the given
+ * size satisfies, that is the lower boundary of its list: requests above it
+ * are rounded up by heap_mapping_search() past the list of the block.
+ */
+static uint32_t heap_allocatable(uint32_t size)
+{
+	if(size >= MARIOS_HEAP_SMALL_BLOCK)
+		size &= ~((1U << (heap_fls(size) - MARIOS_HEAP_SL_LOG2)) - 1);
+	return size;
+}
+
+static void heap_insert(mariOS_heap* heap, heap_block* block)
+{
+	int fl, sl;
+	heap_mapping(BLOCK_SIZE(block), &fl, &sl);
+	block->prev_free = NULL;
+	block->next_free = heap->free_lists[fl][sl];
+	if(NULL != block->next_free)
+		block->next_free->prev_free = block;
+	heap->free_lists[fl][sl] = block;
+	heap->fl_bitmap |= 1U << fl;
+	heap->sl_bitmap[fl] |= 1U << sl;
+	heap->free += BLOCK_SIZE(block);
+	heap->free_blocks++;
+}
+
+static void heap_remove(mariOS_heap* heap, heap_block* block)
+{
+	int fl, sl;
+	heap_mapping(BLOCK_SIZE(block), &fl, &sl);
+	if(NULL != block->next_free)
+		block->next_free->prev_free = block->prev_free;
+	if(NULL != block->prev_free)
+		block->prev_free->next_free = block->next_free;
+	else
+	{
+		heap->free_lists[fl][sl] = block->next_free;
+		if(NULL == block->next_free)
+		{
+			heap->sl_bitmap[fl] &= ~(1U << sl);
+			if(0 == heap->sl_bitmap[fl])
+				heap->fl_bitmap &= ~(1U << fl);
+		}
+	}
+	heap->free -= BLOCK_SIZE(block);
+	heap->free_blocks--;
+}
+
+/**
+ * The function returns a free block into the first non-empty list from
+ * (fl, sl) onward, or NULL if there is none.
+ */
+static heap_block* heap_find(mariOS_heap* heap, int fl, int sl)
+{
+	if(fl >= MARIOS_HEAP_FL_COUNT)
+		return NULL;
+	uint32_t sl_map = heap->sl_bitmap[fl] & (~0U << sl);
+	if(0 == sl_map)
+	{
+		uint32_t fl_map = (fl + 1 < 32) ? heap->fl_bitmap & (~0U << (fl + 1)) : 0;
+		if(0 == fl_map)
+			return NULL;
+		fl = heap_ffs(fl_map);
+		sl_map = heap->sl_bitmap[fl];
+	}
+	return heap->free_lists[fl][heap_ffs(sl_map)];
+}
+
+/**
+ * The function returns a free block of the last non-empty list, which holds
+ * the largest free blocks, or NULL if there is none.
+ */
+static heap_block* heap_find_last(mariOS_heap* heap)
+{
+	if(0 == heap->fl_bitmap)
+		return NULL;
+	int fl = heap_fls(heap->fl_bitmap);
+	return heap->free_lists[fl][heap_fls(heap->sl_bitmap[fl])];
+}
+
+/**
+ * The function sets the size of a block and of the header of the block that
+ * follows it.
+ */
+static void heap_resize(heap_block* block, uint32_t size, uint32_t free_flag)
+{
+	block->size = size | free_flag;
+	BLOCK_NEXT(block)->prev_physical = block;
+}
+
+void initHeap(mariOS_heap* heap, void* region, uint32_t size)
+{
+	uint8_t* start = (uint8_t*)HEAP_ALIGN_UP((uintptr_t)region);
+	uint8_t* end = (uint8_t*)(((uintptr_t)region + size) & ~(uintptr_t)(MARIOS_HEAP_ALIGN - 1));
+	heap_block* previous = NULL;
+	mariOS_heap* known;
+
+	memset(heap, 0, sizeof(*heap));
+	heap->start = start;
+	heap->end = end;
+	/**
+	 * The region is carved into free blocks no larger than the largest class,
+	 * followed by an allocated block of size 0 that stops merges at the end
+	 */
+	while(start + 2*HEAP_HEADER_SIZE + HEAP_MIN_BLOCK <= end)
+	{
+		heap_block* block = (heap_block*)start;
+		uint32_t block_size = end - start - 2*HEAP_HEADER_SIZE;
+		if(block_size > HEAP_MAX_BLOCK)
+			block_size = HEAP_MAX_BLOCK;
+		block->prev_physical = previous;
+		block->size = block_size | HEAP_BLOCK_FREE;
+		heap_insert(heap, block);
+		heap->capacity += block_size;
+		previous = block;
+		start = (uint8_t*)BLOCK_NEXT(block);
+	}
+	if(start + HEAP_HEADER_SIZE <= end)
+	{
+		heap_block* sentinel = (heap_block*)start;
+		sentinel->prev_physical = previous;
+		sentinel->size = 0;
+	}
+
+	enter_critical_section();
+	{
+		for(known = mariOS_heaps; NULL != known && heap != known; known = known->next);
+		if(NULL == known)
+		{
+			heap->next = mariOS_heaps;
+			mariOS_heaps = heap;
+		}
+	}
+	exit_critical_sction();
+}
+
+void* heap_allocate(mariOS_heap* heap, uint32_t size)
+{
+	int fl, sl;
+	heap_block* block;
+	if(0 == size || size > HEAP_MAX_BLOCK)
+		return NULL;
+	size = HEAP_ALIGN_UP(size);
+	if(size < HEAP_MIN_BLOCK)
+		size = HEAP_MIN_BLOCK;
+	heap_mapping_search(size, &fl, &sl);
+
+	enter_critical_section();
+	{
+		block = heap_find(heap, fl, sl);
+		if(NULL == block)
+		{
+			heap->failures++;
+		}
+		else
+		{
+			heap_remove(heap, block);
+			uint32_t block_size = BLOCK_SIZE(block);
+			if(block_size >= size + HEAP_HEADER_SIZE + HEAP_MIN_BLOCK) //The remainder is returned to the heap
+			{
+				heap_resize(block, size, 0);
+				heap_block* remainder = BLOCK_NEXT(block);
+				heap_resize(remainder, block_size - size - HEAP_HEADER_SIZE, HEAP_BLOCK_FREE);
+				heap_insert(heap, remainder);
+			}
+			else
+				block->size = block_size;
+			heap->used += BLOCK_SIZE(block);
+			if(heap->used > heap->peak)
+				heap->peak = heap->used;
+			heap->allocations++;
+		}
+	}
+	exit_critical_sction();
+	return (NULL != block) ? BLOCK_DATA(block) : NULL;
+}
+
+mariOS_heap_op_status_t heap_free(mariOS_heap* heap, void* data)
+{
+	heap_block* block = DATA_BLOCK(data);
+	if((uint8_t*)data < heap->start + HEAP_HEADER_SIZE || (uint8_t*)data >= heap->end || 0 != ((uintptr_t)data & (MARIOS_HEAP_ALIGN - 1)))
+		return MARIOS_HEAP_INVALID_OP;
+
+	mariOS_heap_op_status_t status = MARIOS_HEAP_SUCCESS_OP;
+	enter_critical_section();
+	{
+		if(BLOCK_IS_FREE(block) || 0 == BLOCK_SIZE(block)) //Double free, or the block ending the region
+		{
+			status = MARIOS_HEAP_INVALID_OP;
+		}
+		else
+		{
+			heap->used -= BLOCK_SIZE(block);
+			heap->allocations--;
+			heap_block* previous = block->prev_physical;
+			heap_block* next = BLOCK_NEXT(block);
+			if(NULL != previous && BLOCK_IS_FREE(previous) &&
+			   BLOCK_SIZE(previous) + HEAP_HEADER_SIZE + BLOCK_SIZE(block) <= HEAP_MAX_BLOCK) //Merge with the previous block
+			{
+				block->size |= HEAP_BLOCK_FREE; //The stale header still tells a second free of the block
+				heap_remove(heap, previous);
+				heap_resize(previous, BLOCK_SIZE(previous) + HEAP_HEADER_SIZE + BLOCK_SIZE(block), 0);
+				block = previous;
+			}
+			if(BLOCK_IS_FREE(next) && BLOCK_SIZE(block) + HEAP_HEADER_SIZE + BLOCK_SIZE(next) <= HEAP_MAX_BLOCK) //Merge with the next block
+			{
+				heap_remove(heap, next);
+				heap_resize(block, BLOCK_SIZE(block) + HEAP_HEADER_SIZE + BLOCK_SIZE(next), 0);
+			}
+			block->size |= HEAP_BLOCK_FREE;
+			heap_insert(heap, block);
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+void get_heap_stats(mariOS_heap* heap, mariOS_heap_stats* stats)
+{
+	uint32_t largest = 0;
+	memset(stats, 0, sizeof(*stats));
+	enter_critical_section();
+	{
+		heap_block* block = heap_find_last(heap);
+		if(NULL != block)
+			largest = BLOCK_SIZE(block);
+		stats->capacity = heap->capacity;
+		stats->used = heap->used;
+		stats->peak = heap->peak;
+		stats->free = heap->free;
+		stats->free_blocks = heap->free_blocks;
+		stats->allocations = heap->allocations;
+		stats->failures = heap->failures;
+	}
+	exit_critical_sction();
+	stats->largest_free = heap_allocatable(largest);
+	if(0 != stats->free)
+		stats->fragmentation = 100 - (uint8_t)((uint64_t)largest * 100 / stats->free);
+}
+
+#if MARIOS_CONFIG_HEAP_SIZE
+void mariOS_heap_init(void)
+{
+	initHeap(&mariOS_kernel_heap, mariOS_kernel_heap_region, sizeof(mariOS_kernel_heap_region));
+}
+
+void* mariOS_malloc(uint32_t size)
+{
+	return heap_allocate(&mariOS_kernel_heap, size);
+}
+#endif
+
+mariOS_heap_op_status_t mariOS_free(void* block)
+{
+	mariOS_heap* heap;
+	if(NULL == block)
+		return MARIOS_HEAP_SUCCESS_OP;
+	for(heap = mariOS_heaps; NULL != heap; heap = heap->next)
+		if((uint8_t*)block >= heap->start && (uint8_t*)block < heap->end)
+			return heap_free(heap, block);
+	return MARIOS_HEAP_INVALID_OP;
+}
@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	histogram.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS histograms. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include "histogram.h"
+
+void histogram_record(mariOS_histogram* histogram, uint32_t value)
+{
+	uint8_t bucket = (0 == value) ? 0 : 32 - __builtin_clz(value); //CLZ makes the log2 a single instruction
+	if(bucket >= MARIOS_CONFIG_HISTOGRAM_BUCKETS)
+		bucket = MARIOS_CONFIG_HISTOGRAM_BUCKETS - 1;
+	histogram->buckets[bucket]++;
+	histogram->count++;
+	if(value > histogram->max)
+		histogram->max = value;
+}
+
+void reset_histogram(mariOS_histogram* histogram)
+{
+	memset(histogram, 0, sizeof(mariOS_histogram));
+}
+
+uint32_t get_histogram_bucket_bound(uint8_t bucket)
+{
+	return (0 == bucket) ? 0 : (uint32_t)1 << (bucket - 1);
+}
+
+uint32_t get_histogram_percentile(mariOS_histogram* histogram, uint16_t permille)
+{
+	uint32_t target = (uint32_t)(((uint64_t)histogram->count * permille + 999) / 1000);
+	uint32_t seen = 0;
+	uint8_t i;
+	if(0 == histogram->count)
+		return 0;
+	for(i = 0; i < MARIOS_CONFIG_HISTOGRAM_BUCKETS - 1; i++)
+	{
+		seen += histogram->buckets[i];
+		if(seen >= target)
+			return (get_histogram_bucket_bound(i+1) < histogram->max) ? get_histogram_bucket_bound(i+1) : histogram->max;
+	}
+	return histogram->max;
+}
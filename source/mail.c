@@ -0,0 +1,118 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	mail.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS mail queues. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include "mail.h"
+
+/**
+ * The function tells whether the address is a block of the pool of the mail
+ * queue.
+ */
+static uint8_t is_mail(mariOS_mail_queue* mail_queue, void* mail)
+{
+	uint8_t* address = (uint8_t*)mail;
+	uint8_t* blocks = (uint8_t*)mail_queue->pool.buffer;
+	if(address < blocks || address >= blocks + mail_queue->pool.block_count * mail_queue->pool.block_size)
+		return 0;
+	return 0 == (address - blocks) % mail_queue->pool.block_size;
+}
+
+void initMailQueue(mariOS_mail_queue* mail_queue, uint32_t* blocks, uint8_t* slots, uint32_t mail_size, uint32_t mail_count)
+{
+	initPool(&mail_queue->pool, blocks, mail_size, mail_count);
+	initQueue(&mail_queue->queue, slots, MARIOS_MAIL_QUEUE_SLOTS_SIZE(mail_count), MARIOS_QUEUE_STREAM_MODE);
+	initSemaphore(&mail_queue->free_blocks, mail_count, mail_count);
+	initSemaphore(&mail_queue->mails, 0, mail_count);
+}
+
+void* allocate_mail(mariOS_mail_queue* mail_queue, uint32_t timeout_ticks)
+{
+	if(MARIOS_SEMAPHORE_SUCCESS_OP != take_semaphore(&mail_queue->free_blocks, timeout_ticks))
+		return NULL;
+	return allocate_block(&mail_queue->pool); //The token guarantees that a block is free
+}
+
+void* allocate_zeroed_mail(mariOS_mail_queue* mail_queue, uint32_t timeout_ticks)
+{
+	void* mail = allocate_mail(mail_queue, timeout_ticks);
+	if(NULL != mail)
+		memset(mail, 0, mail_queue->pool.block_size);
+	return mail;
+}
+
+mariOS_mail_op_status_t put_mail(mariOS_mail_queue* mail_queue, void* mail)
+{
+	if(!is_mail(mail_queue, mail))
+		return MARIOS_MAIL_INVALID_OP;
+	//There is a slot for every block, hence the queue cannot be full
+	enqueue(&mail_queue->queue, (uint8_t*)&mail, sizeof(void*), MARIOS_NONBLOCKING_QUEUE_OP);
+	give_semaphore(&mail_queue->mails);
+	return MARIOS_MAIL_SUCCESS_OP;
+}
+
+mariOS_mail_op_status_t put_mail_from_isr(mariOS_mail_queue* mail_queue, void* mail, uint8_t* higher_priority_task_woken)
+{
+	if(!is_mail(mail_queue, mail))
+		return MARIOS_MAIL_INVALID_OP;
+	enqueue_from_isr(&mail_queue->queue, (uint8_t*)&mail, sizeof(void*), NULL);
+	give_semaphore_from_isr(&mail_queue->mails, higher_priority_task_woken);
+	return MARIOS_MAIL_SUCCESS_OP;
+}
+
+mariOS_mail_op_status_t get_mail(mariOS_mail_queue* mail_queue, uint32_t timeout_ticks, void** mail)
+{
+	*mail = NULL;
+	if(MARIOS_SEMAPHORE_SUCCESS_OP != take_semaphore(&mail_queue->mails, timeout_ticks))
+		return MARIOS_MAIL_TIMEOUT_OP;
+	//The token guarantees that the address of a mail has been enqueued
+	if(is_isr_context())
+		dequeue_from_isr(&mail_queue->queue, (uint8_t*)mail, sizeof(void*), NULL);
+	else
+		dequeue(&mail_queue->queue, (uint8_t*)mail, sizeof(void*), MARIOS_NONBLOCKING_QUEUE_OP);
+	return MARIOS_MAIL_SUCCESS_OP;
+}
+
+mariOS_mail_op_status_t free_mail(mariOS_mail_queue* mail_queue, void* mail)
+{
+	if(MARIOS_POOL_SUCCESS_OP != free_block(&mail_queue->pool, mail))
+		return MARIOS_MAIL_INVALID_OP;
+	give_semaphore(&mail_queue->free_blocks);
+	return MARIOS_MAIL_SUCCESS_OP;
+}
+
+mariOS_mail_op_status_t free_mail_from_isr(mariOS_mail_queue* mail_queue, void* mail, uint8_t* higher_priority_task_woken)
+{
+	if(MARIOS_POOL_SUCCESS_OP != free_block(&mail_queue->pool, mail))
+		return MARIOS_MAIL_INVALID_OP;
+	give_semaphore_from_isr(&mail_queue->free_blocks, higher_priority_task_woken);
+	return MARIOS_MAIL_SUCCESS_OP;
+}
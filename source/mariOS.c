@@ -34,15 +34,24 @@
  */
 
 #include "mariOS.h"
+#if MARIOS_CONFIG_TIMERS
+#include "timer.h"
+#endif
+#if MARIOS_CONFIG_HEAP_SIZE
+#include "heap.h"
+#endif
 
 /**
  * Here we define a list containing all tasks that the scheduler must handle.
  * Additionally, the table reports the number of created tasks and the current
- * active task (there is one and only one active task at time)
+ * active task (there is one and only one active task at time).
+ * Statistics are kept apart, so that the control blocks only hold the fields
+ * handled by the scheduler.
  */
 static struct
 {
 	mariOS_task_control_block_t tasks[MARIOS_CONFIG_MAX_TASKS];
+	mariOS_task_statistics_block_t stats[MARIOS_CONFIG_MAX_TASKS]; /** Statistics of the tasks, by task ID */
 	volatile mariOS_task_id_t current_active_task; /** The current executing task */
 	uint16_t size; /** Number of tasks that have been created */
 } mariOS_tasks_list;
@@ -52,6 +61,19 @@ static struct
  */
 volatile uint32_t mariOS_ticks;
 
+/**
+ * Upper word of the 64-bit tick count, incremented each time mariOS_ticks
+ * wraps around, and the cycles of the systick clock between two ticks.
+ */
+static volatile uint32_t mariOS_ticks_high;
+static uint32_t cycles_per_tick;
+
+/**
+ * Cycles taken by a get_time_cycles() call, which bound the resolution of the
+ * spin of mariOS_delay_until(). It is measured by mariOS_start().
+ */
+static uint32_t spin_overhead;
+
 /**
  * These two variables are used to get trace of current executing task
  * and one that has just been scheduled as next one. Once the yield
@@ -61,11 +83,12 @@ mariOS_task_control_block_t* volatile mariOS_curr_task;
 mariOS_task_control_block_t* volatile mariOS_next_task;
 
 /**
- * This values reports, in percentage, the execution of idle
- * during the scheduling lifetime. The value is update each time idle is
- * scheduled in a different mariOS time slice window.
+ * Cycle counter at the last time the active task has been charged for its
+ * execution, and the number of completed statistics windows.
  */
-volatile uint8_t marios_idle_value = 0;
+static uint32_t last_charge_cycles;
+static uint32_t stats_windows;
+static uint32_t stats_window_countdown; /** ticks to the end of the current window */
 
 /**
  * mariOS_idle is the system idle task. It should be modified accordingly to
@@ -73,18 +96,7 @@ volatile uint8_t marios_idle_value = 0;
  */
 static void mariOS_idle()
 {
-	volatile uint64_t idleCount = 0;
-	volatile uint64_t max_idleCount = 83;
-	uint32_t last_marios_tick = 0;
 	while (1){
-		idleCount++;
-		if(last_marios_tick != mariOS_ticks){
-			marios_idle_value = idleCount*100/(max_idleCount*(mariOS_ticks-last_marios_tick));
-			if(max_idleCount < idleCount / (mariOS_ticks-last_marios_tick))
-				max_idleCount = idleCount / (mariOS_ticks-last_marios_tick);
-			last_marios_tick = mariOS_ticks;
-			idleCount = 0;
-		}
 		__disable_irq(); //Here the yield must be protected against other incoming interrupts
 		mariOS_task_yield();
 		__enable_irq();
@@ -103,18 +115,61 @@ static void task_completion(void)
 		i++;
 }
 
-static mariOS_stack_t* idle_stack[MARIOS_IDLE_TASK_STACK] __attribute__ ((aligned (4)));
+static mariOS_stack_t idle_stack[MARIOS_IDLE_TASK_STACK] __attribute__ ((aligned (4)));
+
+/**
+ * The function charges the active task for the cycles elapsed since the last
+ * charge. It must be invoked inside a critical section.
+ */
+static void charge_active_task(void)
+{
+	uint32_t now = read_cycle_counter();
+	mariOS_task_statistics_block_t* stats = &mariOS_tasks_list.stats[mariOS_tasks_list.current_active_task];
+	stats->run_cycles += now - last_charge_cycles;
+	stats->job_cycles += now - last_charge_cycles;
+	last_charge_cycles = now;
+}
+
+/**
+ * The function closes the current statistics window of every task.
+ */
+static void close_stats_window(void)
+{
+	int i;
+	charge_active_task();
+	for(i = 0; i < mariOS_tasks_list.size; i++)
+	{
+		mariOS_tasks_list.stats[i].window_cycles[stats_windows % MARIOS_CONFIG_STATS_WINDOWS] = mariOS_tasks_list.stats[i].run_cycles;
+		mariOS_tasks_list.stats[i].run_cycles = 0;
+	}
+	stats_windows++;
+}
 
 
 void mariOS_init(void)
 {
 	memset(&mariOS_tasks_list, 0, sizeof(mariOS_tasks_list));
 	mariOS_ticks = 0;
+	mariOS_ticks_high = 0;
+	cycles_per_tick = MARIOS_CONFIG_SYSTICK_FREQ;
+	init_cycle_counter();
+	last_charge_cycles = read_cycle_counter();
+	stats_windows = 0;
+	stats_window_countdown = MARIOS_CONFIG_STATS_WINDOW_TICKS;
+#if MARIOS_CONFIG_TRACE
+	mariOS_trace_init(MARIOS_CONFIG_SYSTICK_FREQ);
+#endif
 	/**
 	 * Current idle process implementation does not need a lot of space,
 	 * even though its minimum size depends on the target architecture.
 	 */
-	mariOS_task_init(mariOS_idle, idle_stack, MARIOS_IDLE_TASK_STACK+1, 0, 0);
+	mariOS_task_init(mariOS_idle, idle_stack, MARIOS_IDLE_TASK_STACK, 0, 0);
+#if MARIOS_CONFIG_HEAP_SIZE
+	mariOS_heap_init();
+#endif
+#if MARIOS_CONFIG_TIMERS
+	mariOS_timer_init();
+#endif
 }
 
 mariOS_task_id_t mariOS_task_init(void (*handler)(void), mariOS_stack_t* stack_ptr, uint32_t stack_size, mariOS_priority priority, uint32_t period)
@@ -125,6 +180,7 @@ mariOS_task_id_t mariOS_task_init(void (*handler)(void), mariOS_stack_t* stack_p
 	/* Initialize the task structure and set SP to the top of the stack
 	   minus 16 words (64 bytes) to leave space for storing 16 registers: */
 	mariOS_task_control_block_t *p_task = &mariOS_tasks_list.tasks[mariOS_tasks_list.size];
+	mariOS_task_statistics_block_t *p_stats = &mariOS_tasks_list.stats[mariOS_tasks_list.size];
 	p_task->handler = handler;
 	if(MARIOS_MINIMUM_TASK_STACK_SIZE > stack_size)
 		return -1;
@@ -134,6 +190,31 @@ mariOS_task_id_t mariOS_task_init(void (*handler)(void), mariOS_stack_t* stack_p
 	p_task->status = MARIOS_TASK_STATUS_READY;
 	p_task->wait_ticks = 0;
 	p_task->priority = priority;
+	p_task->base_priority = priority;
+	p_task->timeout = MARIOS_TIMEOUT_NONE;
+	p_task->wait_list = NULL;
+	p_task->next_waiter = MARIOS_INVALID_TASK_ID;
+	p_task->blocked_mutex = NULL;
+	p_task->held_mutexes = NULL;
+	p_task->signals = 0;
+	p_task->signals_wait_mask = 0;
+	p_task->signals_wait = MARIOS_SIGNALS_NOT_WAITING;
+	p_task->notify_value = 0;
+	p_task->notify_state = MARIOS_NOTIFY_NONE;
+	p_task->release_tick = mariOS_ticks;
+	p_task->overrun_policy = MARIOS_OVERRUN_SKIP;
+	p_task->overrun_hook = NULL;
+	memset(p_stats, 0, sizeof(*p_stats));
+	p_stats->release_cycles = read_cycle_counter();
+	p_stats->stack_base = stack_ptr;
+	p_stats->stack_size = stack_size;
+	uint32_t i;
+	for(i = 0; i < stack_size; i++) //The stack is painted to measure its high-water mark
+		stack_ptr[i] = MARIOS_STACK_PAINT;
+#if MARIOS_CONFIG_TASK_HISTOGRAMS
+	reset_histogram(&p_stats->wakeup_latency);
+	reset_histogram(&p_stats->response_time);
+#endif
 	p_task->period = MARIOS_CONFIG_SYSTICK_FREQ_DIV*period/1000;
 
 	//Here we push the stack to it's lower limit, preparing it for the initialization
@@ -146,12 +227,33 @@ mariOS_task_id_t mariOS_task_init(void (*handler)(void), mariOS_stack_t* stack_p
 	return (mariOS_tasks_list.size-1);
 }
 
+/**
+ * The function measures the spin overhead as the shortest of some intervals
+ * between two consecutive time stamps, so that a tick in between does not
+ * spoil it.
+ */
+static void calibrate_spin(void)
+{
+	int i;
+	spin_overhead = 0xFFFFFFFF;
+	for(i = 0; i < 8; i++)
+	{
+		uint64_t first = get_time_cycles();
+		uint64_t second = get_time_cycles();
+		if(second - first < spin_overhead)
+			spin_overhead = (uint32_t)(second - first);
+	}
+}
+
 int mariOS_start(uint32_t systick_ticks)
 {
+	cycles_per_tick = systick_ticks;
 	configureSystick(systick_ticks);
+	calibrate_spin();
 
 	/* Start the first task: should be the first non-idle */
 	mariOS_curr_task = &mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task];
+	mariOS_next_task = mariOS_curr_task;
 
 	loadFirstTask();
 	/** This point should be never reached */
@@ -160,17 +262,38 @@ int mariOS_start(uint32_t systick_ticks)
 
 void marios_systick_handler(void)
 {
-	++mariOS_ticks;
+	if(0 == ++mariOS_ticks) //The 32-bit count wrapped around
+		mariOS_ticks_high++;
+	uint64_t now = ((uint64_t)mariOS_ticks_high << 32) | mariOS_ticks;
+	MARIOS_TRACE(MARIOS_TRACE_TICK, mariOS_tasks_list.current_active_task, (uint16_t)mariOS_ticks);
 
 	int i;
 	for(i = 1; i < mariOS_tasks_list.size; i++) //loop over tasks except for idle one
 	{	//Remove tasks from suspend state if "wait_ticks" elapses
-		//Does not matter mariosTicks overflow, since we are checking the equality
-		if(MARIOS_TASK_STATUS_WAIT == mariOS_tasks_list.tasks[i].status && mariOS_tasks_list.tasks[i].wait_ticks == mariOS_ticks){
+		//Wake times are 64-bit, hence they never wrap around and a late tick cannot skip them
+		if(MARIOS_TASK_STATUS_WAIT == mariOS_tasks_list.tasks[i].status && mariOS_tasks_list.tasks[i].wait_ticks <= now){
 			mariOS_tasks_list.tasks[i].status = MARIOS_TASK_STATUS_READY;
 			mariOS_tasks_list.tasks[i].wait_ticks = 0;
+			mariOS_tasks_list.stats[i].release_cycles = read_cycle_counter();
+			MARIOS_TRACE(MARIOS_TRACE_WAKEUP, i, 0);
+		}
+		//The same holds for suspended tasks whose timeout elapses
+		else if(MARIOS_TASK_STATUS_SUSPEND == mariOS_tasks_list.tasks[i].status && MARIOS_TIMEOUT_ARMED == mariOS_tasks_list.tasks[i].timeout &&
+				mariOS_tasks_list.tasks[i].wait_ticks <= now){
+			mariOS_tasks_list.tasks[i].status = MARIOS_TASK_STATUS_READY;
+			mariOS_tasks_list.tasks[i].timeout = MARIOS_TIMEOUT_EXPIRED;
+			mariOS_tasks_list.tasks[i].wait_ticks = 0;
+			MARIOS_TRACE(MARIOS_TRACE_WAKEUP, i, 1);
 		}
 	}
+#if MARIOS_CONFIG_TIMERS
+	mariOS_timer_tick();
+#endif
+	if(0 == --stats_window_countdown)
+	{
+		stats_window_countdown = MARIOS_CONFIG_STATS_WINDOW_TICKS;
+		close_stats_window();
+	}
 	mariOS_task_yield();
 }
 
@@ -245,15 +368,27 @@ void priority_scheduler()
 
 void mariOS_scheduler(void)
 {
-	/** Retrieve the current active task*/
-	mariOS_curr_task = &mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task];
+	/** Retrieve the current active task. It may differ from mariOS_curr_task whenever a context switch
+	 *  is still pending, since mariOS_curr_task is updated by PendSV_Handler() once the switch occurs */
+	mariOS_task_id_t active_task_id = mariOS_tasks_list.current_active_task;
+	mariOS_task_control_block_t* active_task = &mariOS_tasks_list.tasks[active_task_id];
 
 	/** If it is active, namely it has been set neither in wait nor suspend, its status must be changed in ready */
-	if(MARIOS_TASK_STATUS_ACTIVE == mariOS_curr_task->status)
-		mariOS_curr_task->status = MARIOS_TASK_STATUS_READY;
+	uint8_t preempted = (MARIOS_TASK_STATUS_ACTIVE == active_task->status);
+	if(preempted)
+		active_task->status = MARIOS_TASK_STATUS_READY;
+	charge_active_task();
 
 	/** Now, we need to pick the next task: */
 	MARIOS_SCHEDULER_FUNCTION();
+	if(active_task_id != mariOS_tasks_list.current_active_task)
+	{
+		if(preempted)
+			mariOS_tasks_list.stats[active_task_id].preemptions++;
+		else
+			mariOS_tasks_list.stats[active_task_id].voluntary_switches++;
+	}
+	MARIOS_TRACE(MARIOS_TRACE_SCHEDULE, mariOS_tasks_list.current_active_task, active_task_id);
 
 	mariOS_next_task = &mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task];
 	mariOS_next_task->status = MARIOS_TASK_STATUS_ACTIVE;
@@ -269,9 +404,154 @@ void mariOS_active_after(uint32_t ticks){
 		enter_critical_section(); //Here the yield and scheduling must be protected against other incoming interrupts
 		{
 			mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task].status = MARIOS_TASK_STATUS_WAIT;
-			mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task].wait_ticks = mariOS_ticks+ticks;
+			mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task].wait_ticks = get_ticks64()+ticks;
+			MARIOS_TRACE(MARIOS_TRACE_STATUS, mariOS_tasks_list.current_active_task, MARIOS_TASK_STATUS_WAIT);
 			mariOS_task_yield();
 		}
+		exit_critical_sction(); //Here the context switch occurs
+#if MARIOS_CONFIG_TASK_HISTOGRAMS
+		mariOS_task_statistics_block_t* stats = &mariOS_tasks_list.stats[mariOS_tasks_list.current_active_task];
+		histogram_record(&stats->wakeup_latency, read_cycle_counter() - stats->release_cycles);
+#endif
+	}
+}
+
+int32_t mariOS_delay_until(uint64_t deadline)
+{
+	uint64_t wake_tick = (deadline > MARIOS_CONFIG_DELAY_SPIN_CYCLES) ? (deadline - MARIOS_CONFIG_DELAY_SPIN_CYCLES)/cycles_per_tick : 0;
+	uint64_t ticks;
+	while(wake_tick > (ticks = get_ticks64())) //Whole ticks are slept, a wait at a time if they do not fit 32 bits
+		mariOS_active_after((wake_tick - ticks > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)(wake_tick - ticks));
+	uint64_t now;
+	do //Stopping half a call early centres the error around the deadline
+		now = get_time_cycles();
+	while(now + spin_overhead/2 < deadline);
+	if(now >= deadline)
+		return (now - deadline > INT32_MAX) ? INT32_MAX : (int32_t)(now - deadline);
+	return -(int32_t)(deadline - now);
+}
+
+int32_t mariOS_delay_us(uint32_t microsec)
+{
+	uint64_t start = get_time_cycles();
+	return mariOS_delay_until(start + (uint64_t)microsec*cycles_per_tick*MARIOS_CONFIG_SYSTICK_FREQ_DIV/1000000);
+}
+
+/**
+ * The function accounts for the execution time of the job just completed by
+ * the active task.
+ */
+static void account_job(mariOS_task_statistics_block_t* stats)
+{
+	enter_critical_section();
+	{
+		charge_active_task();
+		uint32_t cycles = stats->job_cycles;
+		stats->job_cycles = 0;
+		if(0 == stats->execution.jobs || cycles < stats->execution.min_cycles)
+			stats->execution.min_cycles = cycles;
+		if(cycles > stats->execution.max_cycles)
+			stats->execution.max_cycles = cycles;
+		stats->execution.total_cycles += cycles;
+		stats->execution.jobs++;
+	}
+	exit_critical_sction();
+}
+
+void mariOS_wait_next_release(void)
+{
+	mariOS_task_control_block_t* task = &mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task];
+	mariOS_task_statistics_block_t* stats = &mariOS_tasks_list.stats[mariOS_tasks_list.current_active_task];
+	uint32_t now = mariOS_ticks;
+	account_job(stats);
+#if MARIOS_CONFIG_TASK_HISTOGRAMS
+	histogram_record(&stats->response_time, read_cycle_counter() - stats->release_cycles);
+#endif
+	if(0 == task->period) //Without a period there is no deadline: the next job is released at once
+	{
+		task->release_tick = now;
+		stats->release_cycles = read_cycle_counter();
+		return;
+	}
+	//The deadline of a job is the release of the next one
+	task->release_tick += task->period;
+	if(!MARIOS_TICKS_REACHED(task->release_tick, now))
+	{
+		mariOS_overrun_policy_t policy = task->overrun_policy;
+		stats->deadline_misses++;
+		if(MARIOS_OVERRUN_HOOK == policy)
+			policy = (NULL != task->overrun_hook) ? task->overrun_hook(mariOS_tasks_list.current_active_task, now - task->release_tick) : MARIOS_OVERRUN_SKIP;
+		if(MARIOS_OVERRUN_CATCH_UP != policy) //The next release is the first one still to come
+		{
+			uint32_t skipped = (now - task->release_tick)/task->period + 1;
+			task->release_tick += skipped*task->period;
+			stats->skipped_releases += skipped;
+		}
+	}
+	if(!MARIOS_TICKS_REACHED(now, task->release_tick))
+		mariOS_active_after(task->release_tick - now);
+	else //The next job has already been released
+		stats->release_cycles = read_cycle_counter();
+}
+
+uint32_t get_task_deadline_misses(mariOS_task_id_t task_id)
+{
+	return mariOS_tasks_list.stats[task_id].deadline_misses;
+}
+
+void set_task_overrun_policy(mariOS_task_id_t task_id, mariOS_overrun_policy_t policy, mariOS_overrun_hook_t hook)
+{
+	enter_critical_section();
+	{
+		mariOS_tasks_list.tasks[task_id].overrun_policy = policy;
+		mariOS_tasks_list.tasks[task_id].overrun_hook = hook;
+	}
+	exit_critical_sction();
+}
+
+uint32_t get_task_skipped_releases(mariOS_task_id_t task_id)
+{
+	return mariOS_tasks_list.stats[task_id].skipped_releases;
+}
+
+uint32_t get_task_execution_stats(mariOS_task_id_t task_id, mariOS_execution_stats* stats)
+{
+	mariOS_execution_stats execution;
+	enter_critical_section();
+	{
+		execution = mariOS_tasks_list.stats[task_id].execution;
+	}
+	exit_critical_sction();
+	if(NULL != stats)
+		*stats = execution;
+	if(0 == execution.jobs)
+		return 0;
+	return (uint32_t)(execution.total_cycles/execution.jobs);
+}
+
+#if MARIOS_CONFIG_TASK_HISTOGRAMS
+void get_task_histograms(mariOS_task_id_t task_id, mariOS_histogram* wakeup_latency, mariOS_histogram* response_time)
+{
+	enter_critical_section();
+	{
+		if(NULL != wakeup_latency)
+			*wakeup_latency = mariOS_tasks_list.stats[task_id].wakeup_latency;
+		if(NULL != response_time)
+			*response_time = mariOS_tasks_list.stats[task_id].response_time;
+	}
+	exit_critical_sction();
+}
+#endif
+
+void mariOS_yield_from_isr(uint8_t higher_priority_task_woken)
+{
+	if(0 != higher_priority_task_woken)
+	{
+		enter_critical_section(); //Scheduling must be protected against interrupts with higher priority, such as the systick
+		{
+			mariOS_task_yield(); /** PendSV has the lowest priority, hence the context switch occurs once
+								  *  every nested ISR has been completed */
+		}
 		exit_critical_sction();
 	}
 }
@@ -288,7 +568,10 @@ void set_current_task_status(mariOS_task_status_t status)
 
 void set_task_status(mariOS_task_id_t task_id, mariOS_task_status_t status)
 {
+	if(MARIOS_TASK_STATUS_READY == status) //The task has been resumed before its timeout, if any
+		mariOS_tasks_list.tasks[task_id].timeout = MARIOS_TIMEOUT_NONE;
 	mariOS_tasks_list.tasks[task_id].status = status;
+	MARIOS_TRACE(MARIOS_TRACE_STATUS, task_id, status);
 }
 
 mariOS_task_status_t get_task_status(mariOS_task_id_t task_id)
@@ -296,6 +579,109 @@ mariOS_task_status_t get_task_status(mariOS_task_id_t task_id)
 	return mariOS_tasks_list.tasks[task_id].status;
 }
 
+mariOS_priority get_task_priority(mariOS_task_id_t task_id)
+{
+	return mariOS_tasks_list.tasks[task_id].priority;
+}
+
+void set_task_priority(mariOS_task_id_t task_id, mariOS_priority priority)
+{
+	mariOS_task_control_block_t* task = &mariOS_tasks_list.tasks[task_id];
+	if(priority == task->priority)
+		return;
+	task->priority = priority;
+	if(NULL != task->wait_list) //The task must be moved according to its new priority
+	{
+		mariOS_wait_list* list = task->wait_list;
+		mariOS_wait_list_remove(task_id);
+		mariOS_wait_list_insert(list, task_id);
+	}
+}
+
+mariOS_task_control_block_t* get_task_control_block(mariOS_task_id_t task_id)
+{
+	return &mariOS_tasks_list.tasks[task_id];
+}
+
+mariOS_task_statistics_block_t* get_task_statistics_block(mariOS_task_id_t task_id)
+{
+	return &mariOS_tasks_list.stats[task_id];
+}
+
+mariOS_task_id_t mariOS_task_set_pop(mariOS_task_set* set)
+{
+	uint32_t w;
+	for(w = 0; w < MARIOS_TASK_SET_WORDS; w++)
+		if(0 != set->words[w])
+		{
+			uint32_t bit = __builtin_clz(set->words[w]); //CLZ gives the lowest task ID of the word
+			set->words[w] &= ~(0x80000000U >> bit);
+			return (mariOS_task_id_t)(w*32 + bit);
+		}
+	return MARIOS_INVALID_TASK_ID;
+}
+
+void mariOS_suspend_current_task(uint32_t timeout_ticks)
+{
+	mariOS_task_control_block_t* task = &mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task];
+	task->status = MARIOS_TASK_STATUS_SUSPEND;
+	if(MARIOS_WAIT_FOREVER == timeout_ticks)
+		task->timeout = MARIOS_TIMEOUT_NONE;
+	else
+	{
+		if(0 == timeout_ticks) //The systick is the earliest chance of waking the task, namely one tick
+			timeout_ticks = 1;
+		task->wait_ticks = get_ticks64() + timeout_ticks;
+		task->timeout = MARIOS_TIMEOUT_ARMED;
+	}
+	mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+						  *	 It will eventually have effect once the critical section ends.
+						  */
+}
+
+uint8_t mariOS_timeout_expired(void)
+{
+	return MARIOS_TIMEOUT_EXPIRED == mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task].timeout;
+}
+
+void mariOS_wait_list_insert(mariOS_wait_list* list, mariOS_task_id_t task_id)
+{
+	mariOS_task_control_block_t* task = &mariOS_tasks_list.tasks[task_id];
+	volatile mariOS_task_id_t* link = &list->head;
+	//Let's skip tasks having a priority greater than or equal to the inserted one
+	while(MARIOS_INVALID_TASK_ID != *link && mariOS_tasks_list.tasks[*link].priority >= task->priority)
+		link = &mariOS_tasks_list.tasks[*link].next_waiter;
+	task->next_waiter = *link;
+	task->wait_list = list;
+	*link = task_id;
+}
+
+mariOS_task_id_t mariOS_wait_list_pop(mariOS_wait_list* list)
+{
+	mariOS_task_id_t task_id = list->head;
+	if(MARIOS_INVALID_TASK_ID != task_id)
+	{
+		list->head = mariOS_tasks_list.tasks[task_id].next_waiter;
+		mariOS_tasks_list.tasks[task_id].next_waiter = MARIOS_INVALID_TASK_ID;
+		mariOS_tasks_list.tasks[task_id].wait_list = NULL;
+	}
+	return task_id;
+}
+
+uint8_t mariOS_wait_list_remove(mariOS_task_id_t task_id)
+{
+	mariOS_task_control_block_t* task = &mariOS_tasks_list.tasks[task_id];
+	if(NULL == task->wait_list)
+		return 0;
+	volatile mariOS_task_id_t* link = &task->wait_list->head;
+	while(task_id != *link)
+		link = &mariOS_tasks_list.tasks[*link].next_waiter;
+	*link = task->next_waiter;
+	task->next_waiter = MARIOS_INVALID_TASK_ID;
+	task->wait_list = NULL;
+	return 1;
+}
+
 uint32_t get_current_task_period(void)
 {
 	return mariOS_tasks_list.tasks[mariOS_tasks_list.current_active_task].period;
@@ -306,6 +692,88 @@ mariOS_task_status_t get_current_task_status(void)
 	return get_task_status(mariOS_tasks_list.current_active_task);
 }
 
+/**
+ * The function reads a consistent pair of 64-bit tick count and cycles
+ * elapsed since that tick, retrying if the systick handler runs in between.
+ */
+static uint64_t read_time(uint32_t* elapsed)
+{
+	uint32_t high, low;
+	uint8_t tick_pending;
+	do
+	{
+		high = mariOS_ticks_high;
+		low = mariOS_ticks;
+		*elapsed = read_systick_elapsed(&tick_pending);
+	} while(low != mariOS_ticks || high != mariOS_ticks_high);
+	return (((uint64_t)high << 32) | low) + tick_pending; //A pending tick has elapsed, even though not yet serviced
+}
+
+uint64_t get_ticks64(void)
+{
+	uint32_t elapsed;
+	return read_time(&elapsed);
+}
+
+uint64_t get_time_cycles(void)
+{
+	uint32_t elapsed;
+	uint64_t ticks = read_time(&elapsed);
+	return ticks*cycles_per_tick + elapsed;
+}
+
+uint64_t get_time_us(void)
+{
+	uint32_t elapsed;
+	uint64_t ticks = read_time(&elapsed);
+	return ticks*1000000/MARIOS_CONFIG_SYSTICK_FREQ_DIV +
+		   (uint64_t)elapsed*1000000/((uint64_t)cycles_per_tick*MARIOS_CONFIG_SYSTICK_FREQ_DIV);
+}
+
 uint8_t get_idle_percentage(void){
-	return marios_idle_value;
+	uint32_t window = (stats_windows + MARIOS_CONFIG_STATS_WINDOWS - 1) % MARIOS_CONFIG_STATS_WINDOWS;
+	uint64_t total = 0;
+	int i;
+	for(i = 0; i < mariOS_tasks_list.size; i++)
+		total += mariOS_tasks_list.stats[i].window_cycles[window];
+	if(0 == total)
+		return 0;
+	return (uint8_t)(mariOS_tasks_list.stats[0].window_cycles[window] * 100 / total);
+}
+
+uint16_t get_tasks_info(mariOS_task_info* info, uint16_t max_tasks)
+{
+	uint16_t count, i, w;
+	enter_critical_section();
+	{
+		count = (mariOS_tasks_list.size < max_tasks) ? mariOS_tasks_list.size : max_tasks;
+		for(i = 0; i < count; i++)
+		{
+			mariOS_task_control_block_t* task = &mariOS_tasks_list.tasks[i];
+			mariOS_task_statistics_block_t* stats = &mariOS_tasks_list.stats[i];
+			info[i].id = i;
+			info[i].status = task->status;
+			info[i].priority = task->priority;
+			info[i].base_priority = task->base_priority;
+			for(w = 0; w < MARIOS_CONFIG_STATS_WINDOWS; w++) //The last completed window comes first
+				info[i].cpu_cycles[w] = stats->window_cycles[(stats_windows + MARIOS_CONFIG_STATS_WINDOWS - 1 - w) % MARIOS_CONFIG_STATS_WINDOWS];
+			info[i].voluntary_switches = stats->voluntary_switches;
+			info[i].preemptions = stats->preemptions;
+			info[i].queue_blocks = stats->queue_blocks;
+			info[i].deadline_misses = stats->deadline_misses;
+			info[i].skipped_releases = stats->skipped_releases;
+			info[i].max_execution_cycles = stats->execution.max_cycles;
+			info[i].stack_size = stats->stack_size;
+		}
+	}
+	exit_critical_sction();
+	for(i = 0; i < count; i++) //The stack grows downward, hence its unused words are at the lowest addresses
+	{
+		mariOS_task_statistics_block_t* stats = &mariOS_tasks_list.stats[i];
+		uint32_t unused = 0;
+		while(unused < stats->stack_size && MARIOS_STACK_PAINT == stats->stack_base[unused])
+			unused++;
+		info[i].stack_high_water = stats->stack_size - unused;
+	}
+	return count;
 }
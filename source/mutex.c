@@ -0,0 +1,179 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	mutex.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS mutex. It contains the implementation
+ * 			of function declared in the corresponding header file, along
+ * 			with the priority inheritance protocol.
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "mutex.h"
+
+/**
+ * The function computes the priority a task deserves: its own one, raised to
+ * the priority of the highest task waiting for any mutex it owns.
+ */
+static mariOS_priority inherited_priority(mariOS_task_id_t task_id)
+{
+	mariOS_task_control_block_t* task = get_task_control_block(task_id);
+	mariOS_priority priority = task->base_priority;
+	mariOS_mutex* mutex;
+	for(mutex = task->held_mutexes; NULL != mutex; mutex = mutex->next_held)
+	{	//Wait lists are ordered, so the head is the waiting task with the highest priority
+		mariOS_task_id_t waiting_task = mutex->waiting_tasks.head;
+		if(MARIOS_INVALID_TASK_ID != waiting_task && get_task_priority(waiting_task) > priority)
+			priority = get_task_priority(waiting_task);
+	}
+	return priority;
+}
+
+/**
+ * The function updates the priority of a task according to the mutexes it
+ * owns and propagates the change along the chain of owners: if the task is
+ * waiting for a mutex, the owner of such a mutex has to be updated as well.
+ */
+static void update_priority(mariOS_task_id_t task_id)
+{
+	while(MARIOS_INVALID_TASK_ID != task_id)
+	{
+		mariOS_priority priority = inherited_priority(task_id);
+		if(priority == get_task_priority(task_id))
+			break; //Nothing changes along the rest of the chain
+		set_task_priority(task_id, priority);
+		mariOS_mutex* blocked_mutex = get_task_control_block(task_id)->blocked_mutex;
+		if(NULL == blocked_mutex)
+			break;
+		task_id = blocked_mutex->owner;
+	}
+}
+
+/**
+ * The function makes a task the owner of a free mutex.
+ */
+static void take_mutex(mariOS_mutex* mutex, mariOS_task_id_t task_id)
+{
+	mariOS_task_control_block_t* task = get_task_control_block(task_id);
+	mutex->owner = task_id;
+	mutex->lock_count = 1;
+	mutex->next_held = task->held_mutexes;
+	task->held_mutexes = mutex;
+}
+
+/**
+ * The function removes a mutex from the list of the mutexes owned by a task.
+ */
+static void release_mutex(mariOS_mutex* mutex, mariOS_task_id_t task_id)
+{
+	mariOS_mutex** link = &get_task_control_block(task_id)->held_mutexes;
+	while(mutex != *link)
+		link = &(*link)->next_held;
+	*link = mutex->next_held;
+	mutex->next_held = NULL;
+	mutex->owner = MARIOS_INVALID_TASK_ID;
+	mutex->lock_count = 0;
+}
+
+void initMutex(mariOS_mutex* mutex)
+{
+	mutex->owner = MARIOS_INVALID_TASK_ID;
+	mutex->lock_count = 0;
+	mutex->waiting_tasks.head = MARIOS_INVALID_TASK_ID;
+	mutex->next_held = NULL;
+}
+
+mariOS_mutex_op_status_t lock_mutex(mariOS_mutex* mutex, uint32_t timeout_ticks)
+{
+	mariOS_mutex_op_status_t status = MARIOS_MUTEX_SUCCESS_OP;
+	mariOS_task_id_t current_task = get_current_task_id();
+	enter_critical_section();
+	{
+		if(MARIOS_INVALID_TASK_ID == mutex->owner) //Fast path: the mutex is free
+		{
+			take_mutex(mutex, current_task);
+		}
+		else if(current_task == mutex->owner) //The owner is locking the mutex again
+		{
+			mutex->lock_count++;
+		}
+		else if(0 == timeout_ticks)
+		{
+			status = MARIOS_MUTEX_TIMEOUT_OP;
+		}
+		else
+		{
+			mariOS_wait_list_insert(&mutex->waiting_tasks, current_task);
+			get_task_control_block(current_task)->blocked_mutex = mutex;
+			update_priority(mutex->owner); //The owner inherits our priority, if higher
+			mariOS_suspend_current_task(timeout_ticks);
+			exit_critical_sction(); //Here the context switch occurs
+
+			enter_critical_section();
+			get_task_control_block(current_task)->blocked_mutex = NULL;
+			if(current_task != mutex->owner) //The mutex has not been handed over before the timeout
+			{
+				mariOS_wait_list_remove(current_task);
+				update_priority(mutex->owner); //The owner may not deserve our priority anymore
+				status = MARIOS_MUTEX_TIMEOUT_OP;
+			}
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_mutex_op_status_t unlock_mutex(mariOS_mutex* mutex)
+{
+	mariOS_task_id_t current_task = get_current_task_id();
+	enter_critical_section();
+	{
+		if(current_task != mutex->owner)
+		{
+			exit_critical_sction();
+			return MARIOS_MUTEX_NOT_OWNER_OP;
+		}
+		if(0 == --mutex->lock_count) //The last recursive unlock releases the mutex
+		{
+			release_mutex(mutex, current_task);
+			update_priority(current_task); //Inheritance due to the released mutex ends here
+
+			mariOS_task_id_t next_owner = mariOS_wait_list_pop(&mutex->waiting_tasks);
+			if(MARIOS_INVALID_TASK_ID != next_owner) //Let's hand the mutex over to the waiting task with the highest priority
+			{
+				get_task_control_block(next_owner)->blocked_mutex = NULL;
+				take_mutex(mutex, next_owner);
+				update_priority(next_owner); //Remaining waiting tasks are now waiting for the new owner
+				set_task_status(next_owner, MARIOS_TASK_STATUS_READY);
+				if(get_task_priority(next_owner) > get_task_priority(current_task))
+					mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+										  *	 It will eventually have effect once the critical section ends.
+										  */
+			}
+		}
+	}
+	exit_critical_sction();
+	return MARIOS_MUTEX_SUCCESS_OP;
+}
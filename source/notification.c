@@ -0,0 +1,135 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	notification.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS direct-to-task notifications. It just
+ * 			contains implementation of function declared in the corresponding
+ * 			header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "notification.h"
+
+/**
+ * The function updates the notification word of a task and resumes it if it
+ * is waiting. It must be invoked inside a critical section and it returns 1
+ * if the task made ready has a priority higher than the current active task.
+ */
+static uint8_t notify(mariOS_task_id_t task_id, uint32_t value, mariOS_notify_action_t action, mariOS_notify_op_status_t* status)
+{
+	mariOS_task_control_block_t* task = get_task_control_block(task_id);
+	*status = MARIOS_NOTIFY_SUCCESS_OP;
+	switch(action)
+	{
+	case MARIOS_NOTIFY_SET_BITS:
+		task->notify_value |= value;
+		break;
+	case MARIOS_NOTIFY_INCREMENT:
+		task->notify_value++;
+		break;
+	case MARIOS_NOTIFY_SET_IF_EMPTY:
+		if(MARIOS_NOTIFY_PENDING == task->notify_state)
+		{
+			*status = MARIOS_NOTIFY_PENDING_OP;
+			return 0;
+		}
+		/* no break */
+	case MARIOS_NOTIFY_OVERWRITE:
+		task->notify_value = value;
+		break;
+	}
+	mariOS_notify_state_t previous_state = task->notify_state;
+	task->notify_state = MARIOS_NOTIFY_PENDING;
+	if(MARIOS_NOTIFY_WAITING == previous_state)
+	{
+		set_task_status(task_id, MARIOS_TASK_STATUS_READY);
+		return task->priority > get_task_priority(get_current_task_id());
+	}
+	return 0;
+}
+
+mariOS_notify_op_status_t notify_task(mariOS_task_id_t task_id, uint32_t value, mariOS_notify_action_t action)
+{
+	mariOS_notify_op_status_t status;
+	enter_critical_section();
+	{
+		if(notify(task_id, value, action, &status))
+			mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+								  *	 It will eventually have effect once the critical section ends.
+								  */
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_notify_op_status_t notify_task_from_isr(mariOS_task_id_t task_id, uint32_t value, mariOS_notify_action_t action, uint8_t* higher_priority_task_woken)
+{
+	mariOS_notify_op_status_t status;
+	enter_critical_section(); //The ISR can be preempted by another one with higher priority
+	{
+		if(notify(task_id, value, action, &status) && NULL != higher_priority_task_woken)
+			*higher_priority_task_woken = 1;
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_notify_op_status_t take_notification(mariOS_notify_take_t mode, uint32_t timeout_ticks, uint32_t* value)
+{
+	mariOS_notify_op_status_t status = MARIOS_NOTIFY_SUCCESS_OP;
+	mariOS_task_control_block_t* task = get_task_control_block(get_current_task_id());
+	enter_critical_section();
+	{
+		if(MARIOS_NOTIFY_PENDING != task->notify_state && 0 != timeout_ticks)
+		{
+			task->notify_state = MARIOS_NOTIFY_WAITING;
+			mariOS_suspend_current_task(timeout_ticks);
+			exit_critical_sction(); //Here the context switch occurs
+			enter_critical_section();
+		}
+		if(MARIOS_NOTIFY_PENDING == task->notify_state)
+		{
+			if(NULL != value)
+				*value = task->notify_value;
+			if(MARIOS_NOTIFY_TAKE_DECREMENT == mode && task->notify_value > 1)
+			{
+				task->notify_value--; //The notification stays pending
+			}
+			else
+			{
+				task->notify_value = 0;
+				task->notify_state = MARIOS_NOTIFY_NONE;
+			}
+		}
+		else //No notification has been received before the timeout
+		{
+			task->notify_state = MARIOS_NOTIFY_NONE;
+			status = MARIOS_NOTIFY_TIMEOUT_OP;
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
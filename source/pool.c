@@ -0,0 +1,159 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	pool.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS fixed-block memory pools. It just
+ * 			contains implementation of function declared in the corresponding
+ * 			header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <string.h>
+#include "pool.h"
+#include "port.h"
+
+#define BLOCK_WORDS(pool) ((pool)->block_size / sizeof(uint32_t))
+#define BLOCK_ADDRESS(pool, index) ((pool)->buffer + (index) * BLOCK_WORDS(pool))
+
+/**
+ * The function pops the first block of the free list and returns its index
+ * plus 1, or 0 if the list is empty. Since the exclusive monitor is cleared
+ * by any exception, nobody can pop and push back the head between the load
+ * and the store, hence the list does not suffer from the ABA problem.
+ */
+static uint32_t pop_free_block(mariOS_pool* pool)
+{
+	uint32_t head;
+	do
+	{
+		head = load_exclusive(&pool->free_list);
+		if(0 == head)
+		{
+			clear_exclusive();
+			return 0;
+		}
+	} while(0 != store_exclusive(&pool->free_list, *BLOCK_ADDRESS(pool, head-1)));
+	return head;
+}
+
+/**
+ * The function carves a never allocated block out of the buffer and returns
+ * its index plus 1, or 0 if the whole buffer has already been carved.
+ */
+static uint32_t carve_block(mariOS_pool* pool)
+{
+	uint32_t carved;
+	do
+	{
+		carved = load_exclusive(&pool->carved);
+		if(carved >= pool->block_count)
+		{
+			clear_exclusive();
+			return 0;
+		}
+	} while(0 != store_exclusive(&pool->carved, carved+1));
+	return carved+1;
+}
+
+/**
+ * The function updates the usage statistics of the pool by delta blocks.
+ */
+static void update_usage(mariOS_pool* pool, int32_t delta)
+{
+	uint32_t used, high_water;
+	do
+	{
+		used = load_exclusive(&pool->used) + delta;
+	} while(0 != store_exclusive(&pool->used, used));
+	do
+	{
+		high_water = load_exclusive(&pool->high_water);
+		if(high_water >= used)
+		{
+			clear_exclusive();
+			return;
+		}
+	} while(0 != store_exclusive(&pool->high_water, used));
+}
+
+void initPool(mariOS_pool* pool, uint32_t* buffer, uint32_t block_size, uint32_t block_count)
+{
+	pool->buffer = buffer;
+	pool->block_size = MARIOS_POOL_BLOCK_SIZE(block_size);
+	pool->block_count = block_count;
+	pool->free_list = 0;
+	pool->carved = 0;
+	pool->used = 0;
+	pool->high_water = 0;
+}
+
+void* allocate_block(mariOS_pool* pool)
+{
+	uint32_t index = pop_free_block(pool);
+	if(0 == index)
+		index = carve_block(pool);
+	if(0 == index)
+		return NULL;
+	update_usage(pool, 1);
+	return BLOCK_ADDRESS(pool, index-1);
+}
+
+void* allocate_zeroed_block(mariOS_pool* pool)
+{
+	void* block = allocate_block(pool);
+	if(NULL != block)
+		memset(block, 0, pool->block_size);
+	return block;
+}
+
+mariOS_pool_op_status_t free_block(mariOS_pool* pool, void* block)
+{
+	uint32_t* address = (uint32_t*)block;
+	if(address < pool->buffer || address >= BLOCK_ADDRESS(pool, pool->block_count))
+		return MARIOS_POOL_INVALID_OP;
+	uint32_t offset = (uint8_t*)block - (uint8_t*)pool->buffer;
+	if(0 != offset % pool->block_size)
+		return MARIOS_POOL_INVALID_OP;
+	uint32_t index = offset / pool->block_size + 1;
+	uint32_t head;
+	do
+	{
+		head = load_exclusive(&pool->free_list);
+		*address = head; //The block links the current head of the list
+	} while(0 != store_exclusive(&pool->free_list, index));
+	update_usage(pool, -1);
+	return MARIOS_POOL_SUCCESS_OP;
+}
+
+uint32_t get_pool_used_blocks(mariOS_pool* pool)
+{
+	return pool->used;
+}
+
+uint32_t get_pool_high_water(mariOS_pool* pool)
+{
+	return pool->high_water;
+}
@@ -110,6 +110,19 @@ uint32_t* initialize_Stack(uint32_t* stack_ptr, void (*task_handler)(void), void
 	*/
 }
 
+/**
+ * When the trace is enabled, PendSV_Handler() records the context switch once
+ * the next task became the current one; r0 (the stack pointer of the next
+ * task) and lr (EXC_RETURN) are preserved across the call.
+ */
+#if MARIOS_CONFIG_TRACE
+#define TRACE_CONTEXT_SWITCH	" push	{r0, lr}	 			\n"\
+								" bl	mariOS_trace_context_switch	\n"\
+								" pop	{r0, lr}	 			\n"
+#else
+#define TRACE_CONTEXT_SWITCH	""
+#endif
+
 __attribute__(( naked )) void PendSV_Handler()
 {
 	__asm volatile(	/* Disable interrupts: */
@@ -169,6 +182,11 @@ __attribute__(( naked )) void PendSV_Handler()
 			" ldr	r1, [r2] 				\n"
 			" ldr	r0, [r1] 				\n"//Got the stack pointer
 
+			/* The next task becomes the current one: */
+			" ldr	r2, =mariOS_curr_task 	\n"
+			" str	r1, [r2] 				\n"
+			TRACE_CONTEXT_SWITCH
+
 			//The process is pretty much like the same, but we pull instead
 			" ldmia	r0!,{r4-r11} 			\n"
 			" msr	psp, r0 				\n"
@@ -201,6 +219,88 @@ void exit_critical_sction()
 	__enable_irq();
 }
 
+uint32_t load_exclusive(volatile uint32_t* address)
+{
+	return __LDREXW(address);
+}
+
+uint32_t store_exclusive(volatile uint32_t* address, uint32_t value)
+{
+	return __STREXW(value, address);
+}
+
+void clear_exclusive()
+{
+	__CLREX();
+}
+
+void memory_barrier()
+{
+	__DMB();
+}
+
+void init_cycle_counter()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; //Enable the DWT unit
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t read_cycle_counter()
+{
+	return DWT->CYCCNT;
+}
+
+uint32_t read_systick_elapsed(uint8_t* tick_pending)
+{
+	uint32_t before, after;
+	do
+	{
+		before = SysTick->VAL;
+		*tick_pending = (0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));
+		after = SysTick->VAL;
+	} while(after > before); //The timer reloaded in between, hence the pending flag may not match
+	return SysTick->LOAD - after;
+}
+
+uint32_t get_active_exception()
+{
+	return SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk;
+}
+
+uint8_t is_isr_context()
+{
+	return 0 != (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk);
+}
+
+/**
+ * NVIC priority of a preemption level, the lowest priority being left to PendSV
+ */
+#define LEVEL_TO_NVIC_PRIORITY(level) (((1 << __NVIC_PRIO_BITS) - 1) - (level))
+
+void configure_job_interrupt(int32_t irq_number, uint8_t level)
+{
+	NVIC_SetPriority((IRQn_Type)irq_number, LEVEL_TO_NVIC_PRIORITY(level));
+	NVIC_EnableIRQ((IRQn_Type)irq_number);
+}
+
+void pend_job_interrupt(int32_t irq_number)
+{
+	NVIC_SetPendingIRQ((IRQn_Type)irq_number);
+}
+
+uint32_t raise_preemption_threshold(uint8_t level)
+{
+	uint32_t threshold = __get_BASEPRI();
+	__set_BASEPRI_MAX(LEVEL_TO_NVIC_PRIORITY(level) << (8 - __NVIC_PRIO_BITS)); //BASEPRI_MAX never lowers the threshold
+	return threshold;
+}
+
+void restore_preemption_threshold(uint32_t threshold)
+{
+	__set_BASEPRI(threshold);
+}
+
 int configureSystick(uint32_t systick_ticks)
 {
 	uint32_t ret_val = SysTick_Config(systick_ticks);
@@ -31,33 +31,325 @@
 
 #include "queue.h"
 
-mariOS_queue* createQueue(uint8_t* buffer, unsigned int size)
+#if MARIOS_CONFIG_QUEUE_STATS
+/**
+ * Head of the list of queues walked by get_next_queue().
+ */
+static mariOS_queue* mariOS_queues_list = NULL;
+
+/**
+ * The function appends the queue to the list of known queues, unless it is
+ * already there. It must be invoked inside a critical section.
+ */
+static void register_queue(mariOS_queue* queue)
+{
+	if(queue->registered)
+		return;
+	queue->registered = 1;
+	queue->next_queue = mariOS_queues_list;
+	mariOS_queues_list = queue;
+}
+
+/**
+ * The function tells whether the queue is into the list of known queues.
+ * It must be invoked inside a critical section.
+ */
+static uint8_t is_queue_listed(mariOS_queue* queue)
+{
+	mariOS_queue* listed;
+	for(listed = mariOS_queues_list; NULL != listed; listed = listed->next_queue)
+		if(queue == listed)
+			return 1;
+	return 0;
+}
+
+/**
+ * The function accounts a suspension started at the given cycle. It must be
+ * invoked inside a critical section.
+ */
+static void account_blocked_time(mariOS_queue* queue, uint32_t blocked_since)
+{
+	uint32_t blocked = read_cycle_counter() - blocked_since;
+	queue->stats.blocked_cycles_total += blocked;
+	if(blocked > queue->stats.blocked_cycles_max)
+		queue->stats.blocked_cycles_max = blocked;
+}
+
+#define QUEUE_STATS_REGISTER(queue)				register_queue(queue)
+#define QUEUE_STATS_ADD(queue, counter, amount)	((queue)->stats.counter += (amount))
+#else
+#define QUEUE_STATS_REGISTER(queue)
+#define QUEUE_STATS_ADD(queue, counter, amount)
+#endif
+
+/**
+ * The function copies size bytes at the head of the queue, splitting the
+ * copy whenever the data wraps around the end of the queue memory.
+ */
+static void queue_write(mariOS_queue* queue, const uint8_t* data, unsigned int size)
+{
+	uint32_t contiguous = queue->size - queue->head;
+	if(size <= contiguous) //The data just is append
+	{
+		memcpy(queue->queueMemory+queue->head, data, size);
+	}
+	else //We need to split the copy
+	{
+		QUEUE_STATS_ADD(queue, wrap_copies, 1);
+		memcpy(queue->queueMemory+queue->head, data, contiguous);
+		memcpy(queue->queueMemory, data+contiguous, size-contiguous);
+	}
+	queue->head += size;
+	if(queue->head >= queue->size)
+		queue->head -= queue->size; //The head just point to the first free location
+	queue->freeMemory -= size;
+}
+
+/**
+ * The function copies size bytes starting offset bytes after the tail of
+ * the queue, without consuming them.
+ */
+static void queue_peek(mariOS_queue* queue, uint32_t offset, uint8_t* data, unsigned int size)
+{
+	uint32_t position = queue->tail + offset;
+	if(position >= queue->size)
+		position -= queue->size;
+	uint32_t contiguous = queue->size - position;
+	if(size <= contiguous) //If the data is stored along the queue
+	{
+		memcpy(data, queue->queueMemory+position, size);
+	}
+	else //We need to split the copy
+	{
+		QUEUE_STATS_ADD(queue, wrap_copies, 1);
+		memcpy(data, queue->queueMemory+position, contiguous);
+		memcpy(data+contiguous, queue->queueMemory, size-contiguous);
+	}
+}
+
+/**
+ * The function consumes size bytes from the tail of the queue.
+ */
+static void queue_discard(mariOS_queue* queue, unsigned int size)
+{
+	queue->tail += size;
+	if(queue->tail >= queue->size)
+		queue->tail -= queue->size; //The tail just point to the next non-free region
+	queue->freeMemory += size;
+}
+
+/**
+ * The function returns the length of the next message of a framed queue.
+ * It must be called only if the queue holds at least one message.
+ */
+static unsigned int queue_frame_size(mariOS_queue* queue)
+{
+	mariOS_queue_frame_header_t header;
+	queue_peek(queue, 0, (uint8_t*)&header, MARIOS_QUEUE_FRAME_HEADER_SIZE);
+	return header;
+}
+
+/**
+ * The function returns the number of bytes a message takes into the queue,
+ * header included, or 0 if a framed message can never fit the queue.
+ */
+static unsigned int queue_required_size(mariOS_queue* queue, unsigned int msg_size)
+{
+	if(MARIOS_QUEUE_FRAMED_MODE != queue->mode)
+		return msg_size;
+	if(msg_size > (mariOS_queue_frame_header_t)-1 || msg_size + MARIOS_QUEUE_FRAME_HEADER_SIZE > queue->size)
+		return 0;
+	return msg_size + MARIOS_QUEUE_FRAME_HEADER_SIZE;
+}
+
+/**
+ * The function returns nonzero if the queue holds the message a reader is
+ * asking for: max_size bytes for a stream queue, a whole message for a
+ * framed one.
+ */
+static int queue_has_message(mariOS_queue* queue, unsigned int max_size)
+{
+	unsigned int required_size = max_size;
+	if(MARIOS_QUEUE_FRAMED_MODE == queue->mode) //A framed message is stored as a whole along with its header
+		required_size = MARIOS_QUEUE_FRAME_HEADER_SIZE;
+	return required_size <= (queue->size - queue->freeMemory);
+}
+
+/**
+ * The function stores a message, which is known to fit the free space of
+ * the queue.
+ */
+static void queue_push(mariOS_queue* queue, uint8_t* msg, unsigned int msg_size)
+{
+	if(MARIOS_QUEUE_FRAMED_MODE == queue->mode)
+	{
+		mariOS_queue_frame_header_t header = msg_size;
+		queue_write(queue, (uint8_t*)&header, MARIOS_QUEUE_FRAME_HEADER_SIZE);
+	}
+	queue_write(queue, msg, msg_size);
+#if MARIOS_CONFIG_QUEUE_STATS
+	queue->stats.messages_in++;
+	queue->stats.bytes_in += msg_size;
+	if(queue->size - queue->freeMemory > queue->stats.peak_occupancy)
+		queue->stats.peak_occupancy = queue->size - queue->freeMemory;
+#endif
+	MARIOS_TRACE(MARIOS_TRACE_QUEUE_SEND, get_current_task_id(), msg_size);
+}
+
+/**
+ * The function retrieves the next message, which is known to be stored
+ * into the queue. A framed message larger than max_size is left into the
+ * queue and ::MARIOS_QUEUE_OVERSIZE_OP is returned.
+ */
+static mariOS_queue_op_status_t queue_pop(mariOS_queue* queue, uint8_t* msg, unsigned int max_size, unsigned int* msg_size)
+{
+	unsigned int size = max_size;
+	if(MARIOS_QUEUE_FRAMED_MODE == queue->mode)
+	{
+		size = queue_frame_size(queue);
+		if(size > max_size)
+			return MARIOS_QUEUE_OVERSIZE_OP;
+		queue_discard(queue, MARIOS_QUEUE_FRAME_HEADER_SIZE);
+	}
+	queue_peek(queue, 0, msg, size);
+	queue_discard(queue, size);
+	if(NULL != msg_size)
+		*msg_size = size;
+	QUEUE_STATS_ADD(queue, messages_out, 1);
+	QUEUE_STATS_ADD(queue, bytes_out, size);
+	MARIOS_TRACE(MARIOS_TRACE_QUEUE_RECEIVE, get_current_task_id(), size);
+	return MARIOS_QUEUE_SUCCESS_OP;
+}
+
+/**
+ * The function makes ready all tasks suspended upon the waiting_tasks set,
+ * emptying it. Only the tasks into the set are visited. It returns 1 if at
+ * least one of them has a priority higher than the current active task.
+ */
+static uint8_t wake_waiting_tasks(mariOS_task_set* waiting_tasks)
+{
+	uint8_t higher_priority_task_woken = 0;
+	mariOS_priority current_priority = get_task_priority(get_current_task_id());
+	mariOS_task_id_t task_id;
+	while(MARIOS_INVALID_TASK_ID != (task_id = mariOS_task_set_pop(waiting_tasks)))
+	{
+		set_task_status(task_id, MARIOS_TASK_STATUS_READY);
+		if(get_task_priority(task_id) > current_priority)
+			higher_priority_task_woken = 1;
+	}
+	return higher_priority_task_woken;
+}
+
+/**
+ * The function makes ready the tasks waiting upon the queue set the queue
+ * belongs to, if any. It returns 1 if at least one of them has a priority
+ * higher than the current active task.
+ */
+static uint8_t notify_queue_set(mariOS_queue* queue)
+{
+	if(NULL == queue->set)
+		return 0;
+	return wake_waiting_tasks(&queue->set->tasks_waiting_to_select);
+}
+
+/**
+ * Control blocks handed out by createQueue() and createFramedQueue().
+ */
+static mariOS_queue mariOS_queues_table[MARIOS_CONFIG_MAX_QUEUES];
+static uint16_t mariOS_queues_table_size = 0;
+
+void initQueue(mariOS_queue* queue, uint8_t* buffer, unsigned int size, mariOS_queue_mode_t mode)
 {
-	mariOS_queue* queue = (mariOS_queue*) malloc(sizeof(mariOS_queue));
 	queue->size = size;
-	queue->queueMemory = buffer;
-	//queue->queueMemory = malloc(size);
+	queue->queueMemory = (int8_t*)buffer;
+	queue->mode = mode;
+	queue->set = NULL;
 	queue->rLock = MARIOS_QUEUE_UNLOCKED; /** we assume to create an unlocked queue */
 	queue->wLock = MARIOS_QUEUE_UNLOCKED;
 	reset_queue(queue); /** reset_queue() is used to perform remaining initializations */
+#if MARIOS_CONFIG_QUEUE_STATS
+	reset_queue_stats(queue);
+	enter_critical_section();
+	{
+		if(!is_queue_listed(queue)) //The control block may not be static, hence its flag may hold garbage
+		{
+			queue->registered = 0;
+			queue->next_queue = NULL;
+			register_queue(queue);
+		}
+	}
+	exit_critical_sction();
+#endif
+}
+
+/**
+ * The function takes a control block from the static table and initializes it.
+ */
+static mariOS_queue* allocate_queue(uint8_t* buffer, unsigned int size, mariOS_queue_mode_t mode)
+{
+	mariOS_queue* queue = NULL;
+	enter_critical_section();
+	{
+		if(mariOS_queues_table_size < MARIOS_CONFIG_MAX_QUEUES)
+			queue = &mariOS_queues_table[mariOS_queues_table_size++];
+	}
+	exit_critical_sction();
+	if(NULL != queue)
+		initQueue(queue, buffer, size, mode);
 	return queue;
 }
 
+mariOS_queue* createQueue(uint8_t* buffer, unsigned int size)
+{
+	return allocate_queue(buffer, size, MARIOS_QUEUE_STREAM_MODE);
+}
+
+mariOS_queue* createFramedQueue(uint8_t* buffer, unsigned int size)
+{
+	return allocate_queue(buffer, size, MARIOS_QUEUE_FRAMED_MODE);
+}
+
 mariOS_queue_op_status_t enqueue(mariOS_queue* queue, uint8_t* msg, unsigned int msg_size, mariOS_blocking_queue_op_t blocking)
 {
+	/**
+	 * A framed message is written as a whole along with its header: if it cannot fit the queue
+	 * even when it is empty, waiting for readers is useless
+	 */
+	unsigned int required_size = queue_required_size(queue, msg_size);
+	if(0 == required_size && 0 != msg_size)
+		return MARIOS_QUEUE_OVERSIZE_OP;
+
+#if MARIOS_CONFIG_QUEUE_STATS
+	uint32_t blocked_since = 0;
+	uint8_t blocked = 0;
+#endif
 	int writtenFlag = 0;
 	while(0 == writtenFlag) //This flag will be set once the writing is achieved
 	{
 		enter_critical_section();
 		{
+#if MARIOS_CONFIG_QUEUE_STATS
+			register_queue(queue);
+			if(blocked) //The task has been resumed
+			{
+				account_blocked_time(queue, blocked_since);
+				blocked = 0;
+			}
+#endif
 			if(MARIOS_QUEUE_UNLOCKED == queue->wLock)
 			{
 				queue->wLock = MARIOS_QUEUE_LOCKED;
-				if(msg_size > queue->freeMemory) //Check available space and yield if no enough space
+				if(required_size > queue->freeMemory) //Check available space and yield if no enough space
 				{
 					if(MARIOS_BLOCKING_QUEUE_OP == blocking)
 					{
-						queue->tasks_waiting_to_send[get_current_task_id()] = 1;
+						mariOS_task_set_add(&queue->tasks_waiting_to_send, get_current_task_id());
+						get_task_statistics_block(get_current_task_id())->queue_blocks++;
+#if MARIOS_CONFIG_QUEUE_STATS
+						blocked_since = read_cycle_counter();
+						blocked = 1;
+#endif
+						MARIOS_TRACE(MARIOS_TRACE_QUEUE_BLOCK, get_current_task_id(), 0);
 						set_current_task_status(MARIOS_TASK_STATUS_SUSPEND);
 						mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
 						 	 	 	 	 	  *	It will eventually have effect once the critical section ends.
@@ -69,6 +361,7 @@ mariOS_queue_op_status_t enqueue(mariOS_queue* queue, uint8_t* msg, unsigned int
 						* the queue is full (::MARIOS_QUEUE_FULL_OP). Before returning, we must exit from the critical
 						* section as well as we must unlock the writing operations on the queue
 					    */
+						QUEUE_STATS_ADD(queue, full_rejections, 1);
 						queue->wLock = MARIOS_QUEUE_UNLOCKED;
 						exit_critical_sction();
 						return MARIOS_QUEUE_FULL_OP;
@@ -76,32 +369,17 @@ mariOS_queue_op_status_t enqueue(mariOS_queue* queue, uint8_t* msg, unsigned int
 				}
 				else //Space available
 				{
-					if(queue->head+msg_size <= queue->size) //The message just is append
-					{
-						memcpy(queue->queueMemory+queue->head, msg, msg_size);
-						queue->head += msg_size;
-					}
-					else //We need to split the copy
-					{
-						memcpy(queue->queueMemory+queue->head, msg, queue->size-queue->head);
-						memcpy(queue->queueMemory, msg+queue->size-queue->head, msg_size-(queue->size-queue->head));
-						queue->head = msg_size-(queue->size-queue->head); //The head just point to the first free location
-					}
-					queue->freeMemory -= msg_size;
+					queue_push(queue, msg, msg_size);
 					//Let's make awaken suspended tasks
-					int i;
-					for(i = 0; i < MARIOS_CONFIG_MAX_TASKS; i++)
-						if(1 == queue->tasks_waiting_to_receive[i])
-						{
-							set_task_status(i, MARIOS_TASK_STATUS_READY);
-							queue->tasks_waiting_to_receive[i] = 0;
-						}
+					wake_waiting_tasks(&queue->tasks_waiting_to_receive);
+					notify_queue_set(queue);
 					writtenFlag = 1;
 				}
 				queue->wLock = MARIOS_QUEUE_UNLOCKED;
 			}
 			else //The queue is just locked for sending
 			{
+				QUEUE_STATS_ADD(queue, busy_retries, 1);
 				if(MARIOS_BLOCKING_QUEUE_OP == blocking)
 				{
 					mariOS_task_yield();	/** The yield call has no effect since it is invoked inside a critical section!
@@ -130,19 +408,42 @@ mariOS_queue_op_status_t enqueue(mariOS_queue* queue, uint8_t* msg, unsigned int
 
 mariOS_queue_op_status_t dequeue(mariOS_queue* queue, uint8_t* msg, unsigned int msg_size, mariOS_blocking_queue_op_t blocking)
 {
+	return dequeue_frame(queue, msg, msg_size, NULL, blocking);
+}
+
+mariOS_queue_op_status_t dequeue_frame(mariOS_queue* queue, uint8_t* msg, unsigned int max_size, unsigned int* msg_size, mariOS_blocking_queue_op_t blocking)
+{
+#if MARIOS_CONFIG_QUEUE_STATS
+	uint32_t blocked_since = 0;
+	uint8_t blocked = 0;
+#endif
 	int receivedFlag = 0;
 	while(0 == receivedFlag) //This flag will be set once the writing is achieved
 	{
 		enter_critical_section();
 		{
+#if MARIOS_CONFIG_QUEUE_STATS
+			register_queue(queue);
+			if(blocked) //The task has been resumed
+			{
+				account_blocked_time(queue, blocked_since);
+				blocked = 0;
+			}
+#endif
 			if(MARIOS_QUEUE_UNLOCKED == queue->rLock)
 			{
 				queue->rLock = MARIOS_QUEUE_LOCKED;
-				if(msg_size > (queue->size - queue->freeMemory)) //Check whether the queue is containing at least one msg
+				if(!queue_has_message(queue, max_size)) //Check whether the queue is containing at least one msg
 				{
 					if(MARIOS_BLOCKING_QUEUE_OP == blocking)
 					{
-						queue->tasks_waiting_to_receive[get_current_task_id()] = 1;
+						mariOS_task_set_add(&queue->tasks_waiting_to_receive, get_current_task_id());
+						get_task_statistics_block(get_current_task_id())->queue_blocks++;
+#if MARIOS_CONFIG_QUEUE_STATS
+						blocked_since = read_cycle_counter();
+						blocked = 1;
+#endif
+						MARIOS_TRACE(MARIOS_TRACE_QUEUE_BLOCK, get_current_task_id(), 1);
 						set_current_task_status(MARIOS_TASK_STATUS_SUSPEND);
 						mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
 											  *	 It will eventually have effect once the critical section ends.
@@ -154,6 +455,7 @@ mariOS_queue_op_status_t dequeue(mariOS_queue* queue, uint8_t* msg, unsigned int
 						* the queue is empty (::MARIOS_QUEUE_EMPTY_OP). Before returning, we must exit from the critical
 						* section as well as we must unlock the reading operations on the queue
 					    */
+						QUEUE_STATS_ADD(queue, empty_rejections, 1);
 						queue->rLock = MARIOS_QUEUE_UNLOCKED;
 						exit_critical_sction();
 						return MARIOS_QUEUE_EMPTY_OP;
@@ -161,32 +463,24 @@ mariOS_queue_op_status_t dequeue(mariOS_queue* queue, uint8_t* msg, unsigned int
 				}
 				else //There is at least one msg
 				{
-					if(queue->tail+msg_size <= queue->size) //If the message is stored along the queue
-					{
-						memcpy(msg, queue->queueMemory+queue->tail,msg_size);
-						queue->tail += msg_size;
-					}
-					else //We need to split the copy
-					{
-						memcpy(msg, queue->queueMemory+queue->tail, queue->size-queue->tail);
-						memcpy(msg+queue->size-queue->tail, queue->queueMemory, msg_size-(queue->size-queue->tail));
-						queue->tail = msg_size-(queue->size-queue->tail); //The tail just point to the next non-free region
+					if(MARIOS_QUEUE_SUCCESS_OP != queue_pop(queue, msg, max_size, msg_size))
+					{	/**
+						 * The message is left into the queue: waiting is useless since the reader buffer
+						 * will never fit it
+						 */
+						queue->rLock = MARIOS_QUEUE_UNLOCKED;
+						exit_critical_sction();
+						return MARIOS_QUEUE_OVERSIZE_OP;
 					}
-					queue->freeMemory += msg_size;
 					//Let's make awaken suspended tasks
-					int i;
-					for(i = 0; i < MARIOS_CONFIG_MAX_TASKS; i++)
-						if(1 == queue->tasks_waiting_to_send[i])
-						{
-							set_task_status(i, MARIOS_TASK_STATUS_READY);
-							queue->tasks_waiting_to_send[i] = 0;
-						}
+					wake_waiting_tasks(&queue->tasks_waiting_to_send);
 					receivedFlag = 1;
 				}
 				queue->rLock = MARIOS_QUEUE_UNLOCKED;
 			}
 			else //The queue is just locked for receiving
 			{
+				QUEUE_STATS_ADD(queue, busy_retries, 1);
 				if(MARIOS_BLOCKING_QUEUE_OP == blocking)
 				{
 					mariOS_task_yield();	/** the yield call has no effect since it is invoked inside a critical section!
@@ -213,20 +507,232 @@ mariOS_queue_op_status_t dequeue(mariOS_queue* queue, uint8_t* msg, unsigned int
 	return MARIOS_QUEUE_SUCCESS_OP;
 }
 
+mariOS_queue_op_status_t enqueue_from_isr(mariOS_queue* queue, uint8_t* msg, unsigned int msg_size, uint8_t* higher_priority_task_woken)
+{
+	mariOS_queue_op_status_t status = MARIOS_QUEUE_SUCCESS_OP;
+	unsigned int required_size = queue_required_size(queue, msg_size);
+	if(0 == required_size && 0 != msg_size)
+		return MARIOS_QUEUE_OVERSIZE_OP;
+
+	enter_critical_section(); //The ISR can be preempted by another one with higher priority
+	{
+		QUEUE_STATS_REGISTER(queue);
+		if(MARIOS_QUEUE_UNLOCKED != queue->wLock)
+		{
+			QUEUE_STATS_ADD(queue, busy_retries, 1);
+			status = MARIOS_QUEUE_BUSY_OP;
+		}
+		else if(required_size > queue->freeMemory)
+		{
+			QUEUE_STATS_ADD(queue, full_rejections, 1);
+			status = MARIOS_QUEUE_FULL_OP;
+		}
+		else
+		{
+			queue_push(queue, msg, msg_size);
+			uint8_t woken = wake_waiting_tasks(&queue->tasks_waiting_to_receive);
+			woken |= notify_queue_set(queue);
+			if(woken && NULL != higher_priority_task_woken)
+				*higher_priority_task_woken = 1;
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_queue_op_status_t dequeue_from_isr(mariOS_queue* queue, uint8_t* msg, unsigned int msg_size, uint8_t* higher_priority_task_woken)
+{
+	mariOS_queue_op_status_t status;
+	enter_critical_section(); //The ISR can be preempted by another one with higher priority
+	{
+		QUEUE_STATS_REGISTER(queue);
+		if(MARIOS_QUEUE_UNLOCKED != queue->rLock)
+		{
+			QUEUE_STATS_ADD(queue, busy_retries, 1);
+			status = MARIOS_QUEUE_BUSY_OP;
+		}
+		else if(!queue_has_message(queue, msg_size))
+		{
+			QUEUE_STATS_ADD(queue, empty_rejections, 1);
+			status = MARIOS_QUEUE_EMPTY_OP;
+		}
+		else
+		{
+			status = queue_pop(queue, msg, msg_size, NULL);
+			if(MARIOS_QUEUE_SUCCESS_OP == status && wake_waiting_tasks(&queue->tasks_waiting_to_send) && NULL != higher_priority_task_woken)
+				*higher_priority_task_woken = 1;
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_queue_op_status_t peek_frame_size(mariOS_queue* queue, unsigned int* msg_size)
+{
+	mariOS_queue_op_status_t status = MARIOS_QUEUE_SUCCESS_OP;
+	enter_critical_section();
+	{
+		if(MARIOS_QUEUE_UNLOCKED != queue->rLock)
+			status = MARIOS_QUEUE_BUSY_OP;
+		else if(MARIOS_QUEUE_FRAME_HEADER_SIZE > (queue->size - queue->freeMemory))
+			status = MARIOS_QUEUE_EMPTY_OP;
+		else
+			*msg_size = queue_frame_size(queue);
+	}
+	exit_critical_sction();
+	return status;
+}
+
 void reset_queue(mariOS_queue* queue)
 {
 	if(MARIOS_QUEUE_UNLOCKED == queue->rLock && MARIOS_QUEUE_UNLOCKED == queue->wLock) /** before continue, we must be sure the queue are not blocked */
 	{
-		int i;
-		for(i = 0; i < queue->size; i++)
-			queue->queueMemory[i] = 0;
+#if !MARIOS_CONFIG_QUEUE_LAZY_RESET
+		memset(queue->queueMemory, 0, queue->size);
+#endif
 		queue->head = 0;
 		queue->tail = 0;
 		queue->freeMemory = queue->size;
-		for(i = 0; i < MARIOS_CONFIG_MAX_TASKS; i++)
+		memset(&queue->tasks_waiting_to_receive, 0, sizeof(queue->tasks_waiting_to_receive));
+		memset(&queue->tasks_waiting_to_send, 0, sizeof(queue->tasks_waiting_to_send));
+	}
+}
+
+mariOS_queue* get_next_queue(mariOS_queue* queue)
+{
+#if MARIOS_CONFIG_QUEUE_STATS
+	if(NULL == queue)
+		return mariOS_queues_list;
+	return queue->next_queue;
+#else
+	(void)queue;
+	return NULL;
+#endif
+}
+
+void unregister_queue(mariOS_queue* queue)
+{
+#if MARIOS_CONFIG_QUEUE_STATS
+	enter_critical_section();
+	{
+		mariOS_queue** link = &mariOS_queues_list;
+		while(NULL != *link && queue != *link)
+			link = &(*link)->next_queue;
+		if(NULL != *link)
+			*link = queue->next_queue;
+		queue->next_queue = NULL;
+		queue->registered = 0;
+	}
+	exit_critical_sction();
+#else
+	(void)queue;
+#endif
+}
+
+mariOS_queue_op_status_t get_queue_stats(mariOS_queue* queue, mariOS_queue_stats* stats)
+{
+#if MARIOS_CONFIG_QUEUE_STATS
+	enter_critical_section();
+	{
+		*stats = queue->stats;
+	}
+	exit_critical_sction();
+	return MARIOS_QUEUE_SUCCESS_OP;
+#else
+	(void)queue;
+	(void)stats;
+	return MARIOS_QUEUE_EMPTY_OP;
+#endif
+}
+
+void reset_queue_stats(mariOS_queue* queue)
+{
+#if MARIOS_CONFIG_QUEUE_STATS
+	enter_critical_section();
+	{
+		memset(&queue->stats, 0, sizeof(queue->stats));
+		queue->stats.peak_occupancy = queue->size - queue->freeMemory;
+	}
+	exit_critical_sction();
+#else
+	(void)queue;
+#endif
+}
+
+mariOS_queue_op_status_t add_to_queue_set(mariOS_queue_set* set, mariOS_queue* queue)
+{
+	mariOS_queue_op_status_t status = MARIOS_QUEUE_SUCCESS_OP;
+	enter_critical_section();
+	{
+		if(NULL != queue->set)
+			status = MARIOS_QUEUE_BUSY_OP;
+		else if(set->size >= MARIOS_CONFIG_QUEUE_SET_SIZE)
+			status = MARIOS_QUEUE_FULL_OP;
+		else
+		{
+			set->members[set->size++] = queue;
+			queue->set = set;
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_queue_op_status_t remove_from_queue_set(mariOS_queue_set* set, mariOS_queue* queue)
+{
+	mariOS_queue_op_status_t status = MARIOS_QUEUE_EMPTY_OP;
+	enter_critical_section();
+	{
+		int i;
+		for(i = 0; i < set->size; i++)
+			if(set->members[i] == queue)
+			{
+				set->members[i] = set->members[--set->size]; //The last member takes the place of the removed one
+				set->members[set->size] = NULL;
+				queue->set = NULL;
+				status = MARIOS_QUEUE_SUCCESS_OP;
+				break;
+			}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_queue* select_from_queue_set(mariOS_queue_set* set, mariOS_blocking_queue_op_t blocking)
+{
+	mariOS_queue* selected = NULL;
+	while(NULL == selected) //The loop ends once a member with data is found
+	{
+		enter_critical_section();
 		{
-			queue->tasks_waiting_to_receive[i] = 0;
-			queue->tasks_waiting_to_send[i] = 0;
+			int i;
+			for(i = 1; i <= set->size && NULL == selected; i++)
+			{
+				uint8_t index = (set->last_selected + i) % set->size;
+				if(queue_has_message(set->members[index], 1))
+				{
+					selected = set->members[index];
+					set->last_selected = index;
+				}
+			}
+			if(NULL == selected)
+			{
+				if(MARIOS_BLOCKING_QUEUE_OP == blocking)
+				{
+					mariOS_task_set_add(&set->tasks_waiting_to_select, get_current_task_id());
+					set_current_task_status(MARIOS_TASK_STATUS_SUSPEND);
+					mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+										  *	 It will eventually have effect once the critical section ends.
+										  */
+				}
+				else
+				{
+					exit_critical_sction();
+					return NULL;
+				}
+			}
 		}
+		exit_critical_sction();
 	}
+	return selected;
 }
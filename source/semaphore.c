@@ -0,0 +1,171 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	semaphore.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS semaphore. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "semaphore.h"
+
+/**
+ * The function hands a token over to the waiting task with the highest
+ * priority, or stores it whenever tasks stopped waiting in the meantime.
+ * It must be invoked inside a critical section and it returns 1 if the
+ * task made ready has a priority higher than the current active task.
+ */
+static uint8_t give_contended(mariOS_semaphore* semaphore, mariOS_semaphore_op_status_t* status)
+{
+	*status = MARIOS_SEMAPHORE_SUCCESS_OP;
+	if(semaphore->count >= semaphore->max_count)
+	{
+		*status = MARIOS_SEMAPHORE_FULL_OP;
+		return 0;
+	}
+	if(semaphore->count++ >= 0) //Nobody is waiting
+		return 0;
+	mariOS_task_id_t task_id = mariOS_wait_list_pop(&semaphore->waiting_tasks);
+	set_task_status(task_id, MARIOS_TASK_STATUS_READY);
+	return get_task_priority(task_id) > get_task_priority(get_current_task_id());
+}
+
+/**
+ * The function tries to update the count without any critical section.
+ * It returns 0 whenever the count is negative, namely tasks are waiting
+ * and the contended path must be taken.
+ */
+static uint8_t give_uncontended(mariOS_semaphore* semaphore, mariOS_semaphore_op_status_t* status)
+{
+	int32_t count;
+	do
+	{
+		count = (int32_t)load_exclusive((volatile uint32_t*)&semaphore->count);
+		if(count < 0)
+		{
+			clear_exclusive();
+			return 0;
+		}
+		if(count >= semaphore->max_count)
+		{
+			clear_exclusive();
+			*status = MARIOS_SEMAPHORE_FULL_OP;
+			return 1;
+		}
+	} while(0 != store_exclusive((volatile uint32_t*)&semaphore->count, count+1));
+	*status = MARIOS_SEMAPHORE_SUCCESS_OP;
+	return 1;
+}
+
+void initSemaphore(mariOS_semaphore* semaphore, int32_t initial_count, int32_t max_count)
+{
+	semaphore->count = initial_count;
+	semaphore->max_count = max_count;
+	semaphore->waiting_tasks.head = MARIOS_INVALID_TASK_ID;
+}
+
+mariOS_semaphore_op_status_t take_semaphore(mariOS_semaphore* semaphore, uint32_t timeout_ticks)
+{
+	//Fast path: a token is available
+	int32_t count;
+	do
+	{
+		count = (int32_t)load_exclusive((volatile uint32_t*)&semaphore->count);
+		if(count <= 0)
+		{
+			clear_exclusive();
+			break;
+		}
+	} while(0 != store_exclusive((volatile uint32_t*)&semaphore->count, count-1));
+	if(count > 0)
+		return MARIOS_SEMAPHORE_SUCCESS_OP;
+
+	mariOS_semaphore_op_status_t status = MARIOS_SEMAPHORE_SUCCESS_OP;
+	enter_critical_section();
+	{
+		if(semaphore->count > 0) //A token has been given in the meantime
+		{
+			semaphore->count--;
+		}
+		else if(0 == timeout_ticks)
+		{
+			status = MARIOS_SEMAPHORE_TIMEOUT_OP;
+		}
+		else
+		{
+			mariOS_task_id_t current_task = get_current_task_id();
+			semaphore->count--; //The count keeps trace of the waiting tasks
+			mariOS_wait_list_insert(&semaphore->waiting_tasks, current_task);
+			mariOS_suspend_current_task(timeout_ticks);
+			exit_critical_sction(); //Here the context switch occurs
+
+			enter_critical_section();
+			if(mariOS_wait_list_remove(current_task)) //No token has been handed over before the timeout
+			{
+				semaphore->count++;
+				status = MARIOS_SEMAPHORE_TIMEOUT_OP;
+			}
+		}
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_semaphore_op_status_t give_semaphore(mariOS_semaphore* semaphore)
+{
+	mariOS_semaphore_op_status_t status;
+	if(give_uncontended(semaphore, &status))
+		return status;
+	enter_critical_section();
+	{
+		if(give_contended(semaphore, &status))
+			mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+								  *	 It will eventually have effect once the critical section ends.
+								  */
+	}
+	exit_critical_sction();
+	return status;
+}
+
+mariOS_semaphore_op_status_t give_semaphore_from_isr(mariOS_semaphore* semaphore, uint8_t* higher_priority_task_woken)
+{
+	mariOS_semaphore_op_status_t status;
+	if(give_uncontended(semaphore, &status))
+		return status;
+	enter_critical_section(); //The ISR can be preempted by another one with higher priority
+	{
+		if(give_contended(semaphore, &status) && NULL != higher_priority_task_woken)
+			*higher_priority_task_woken = 1;
+	}
+	exit_critical_sction();
+	return status;
+}
+
+int32_t get_semaphore_count(mariOS_semaphore* semaphore)
+{
+	int32_t count = semaphore->count;
+	return (count > 0) ? count : 0;
+}
@@ -0,0 +1,97 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	srp.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of the mariOS Stack Resource Policy. It just
+ * 			contains implementation of function declared in the corresponding
+ * 			header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "srp.h"
+
+mariOS_srp_op_status_t initJob(mariOS_job* job, mariOS_job_handler_t handler, void* argument, int32_t irq_number, uint8_t level)
+{
+	job->handler = handler;
+	job->argument = argument;
+	job->irq_number = irq_number;
+	job->level = level;
+	job->releases = 0;
+	return enable_job(job);
+}
+
+mariOS_srp_op_status_t enable_job(mariOS_job* job)
+{
+	if(0 == job->level || job->level > MARIOS_SRP_MAX_LEVEL)
+		return MARIOS_SRP_INVALID_LEVEL_OP;
+	configure_job_interrupt(job->irq_number, job->level);
+	return MARIOS_SRP_SUCCESS_OP;
+}
+
+void release_job(mariOS_job* job)
+{
+	uint32_t releases;
+	do
+	{
+		releases = load_exclusive(&job->releases);
+	} while(0 != store_exclusive(&job->releases, releases+1));
+	pend_job_interrupt(job->irq_number);
+}
+
+void mariOS_job_dispatch(mariOS_job* job)
+{
+	uint32_t releases;
+	while(1)
+	{
+		do
+		{
+			releases = load_exclusive(&job->releases);
+			if(0 == releases)
+			{
+				clear_exclusive();
+				return;
+			}
+		} while(0 != store_exclusive(&job->releases, releases-1));
+		job->handler(job->argument);
+	}
+}
+
+void use_resource(mariOS_srp_resource* resource, mariOS_job* job)
+{
+	if(job->level > resource->ceiling)
+		resource->ceiling = job->level;
+}
+
+void lock_resource(mariOS_srp_resource* resource)
+{
+	uint32_t threshold = raise_preemption_threshold(resource->ceiling);
+	resource->saved_threshold = threshold; //Nobody else can lock the resource until it is unlocked
+}
+
+void unlock_resource(mariOS_srp_resource* resource)
+{
+	restore_preemption_threshold(resource->saved_threshold);
+}
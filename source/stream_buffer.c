@@ -0,0 +1,173 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	stream_buffer.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS stream buffers. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "stream_buffer.h"
+
+/**
+ * The function returns the number of bytes between from and to.
+ */
+static uint32_t stream_distance(mariOS_stream_buffer* stream, uint32_t from, uint32_t to)
+{
+	return (to >= from) ? to - from : stream->size - from + to;
+}
+
+/**
+ * The function copies the bytes into the buffer and then publishes them by
+ * moving the head. It is invoked by the writer only.
+ */
+static uint32_t stream_write(mariOS_stream_buffer* stream, const uint8_t* data, uint32_t size)
+{
+	uint32_t head = stream->head;
+	uint32_t space = stream->size - 1 - stream_distance(stream, stream->tail, head);
+	if(size > space)
+		size = space;
+	uint32_t chunk = stream->size - head; //Bytes before the end of the memory
+	if(chunk > size)
+		chunk = size;
+	memcpy(stream->buffer + head, data, chunk);
+	memcpy(stream->buffer, data + chunk, size - chunk);
+	memory_barrier(); //The bytes are written before the head
+	head += size;
+	stream->head = (head >= stream->size) ? head - stream->size : head;
+	return size;
+}
+
+/**
+ * The function makes the waiting reader ready if enough bytes are available.
+ * It returns 1 if the reader has a priority higher than the current active task.
+ */
+static uint8_t wake_reader(mariOS_stream_buffer* stream)
+{
+	uint8_t woken = 0;
+	if(MARIOS_INVALID_TASK_ID == stream->reader)
+		return 0;
+	enter_critical_section();
+	{
+		mariOS_task_id_t reader = stream->reader;
+		if(MARIOS_INVALID_TASK_ID != reader && get_stream_available(stream) >= stream->reader_level)
+		{
+			stream->reader = MARIOS_INVALID_TASK_ID;
+			set_task_status(reader, MARIOS_TASK_STATUS_READY);
+			woken = get_task_priority(reader) > get_task_priority(get_current_task_id());
+		}
+	}
+	exit_critical_sction();
+	return woken;
+}
+
+/**
+ * The function bounds a trigger level between 1 and the capacity of the
+ * stream buffer, namely size-1 bytes, so that it can always be reached.
+ */
+static uint32_t clamp_trigger_level(mariOS_stream_buffer* stream, uint32_t trigger_level)
+{
+	if(trigger_level >= stream->size)
+		trigger_level = stream->size - 1;
+	return (0 == trigger_level) ? 1 : trigger_level;
+}
+
+void initStreamBuffer(mariOS_stream_buffer* stream, uint8_t* buffer, uint32_t size, uint32_t trigger_level)
+{
+	stream->buffer = buffer;
+	stream->size = size;
+	stream->head = 0;
+	stream->tail = 0;
+	stream->trigger_level = clamp_trigger_level(stream, trigger_level);
+	stream->reader = MARIOS_INVALID_TASK_ID;
+	stream->reader_level = 0;
+}
+
+uint32_t send_stream(mariOS_stream_buffer* stream, const uint8_t* data, uint32_t size)
+{
+	uint32_t written = stream_write(stream, data, size);
+	if(wake_reader(stream))
+	{
+		enter_critical_section();
+		mariOS_task_yield(); /** the yield call has no effect since it is invoked inside a critical section!
+							  *	 It will eventually have effect once the critical section ends.
+							  */
+		exit_critical_sction();
+	}
+	return written;
+}
+
+uint32_t send_stream_from_isr(mariOS_stream_buffer* stream, const uint8_t* data, uint32_t size, uint8_t* higher_priority_task_woken)
+{
+	uint32_t written = stream_write(stream, data, size);
+	if(wake_reader(stream) && NULL != higher_priority_task_woken)
+		*higher_priority_task_woken = 1;
+	return written;
+}
+
+uint32_t receive_stream(mariOS_stream_buffer* stream, uint8_t* data, uint32_t max_size, uint32_t timeout_ticks)
+{
+	uint32_t level = (stream->trigger_level < max_size) ? stream->trigger_level : max_size;
+	if(get_stream_available(stream) < level && 0 != timeout_ticks)
+	{
+		enter_critical_section();
+		if(get_stream_available(stream) < level) //The writer may have written in the meantime
+		{
+			stream->reader_level = level;
+			stream->reader = get_current_task_id();
+			mariOS_suspend_current_task(timeout_ticks);
+			exit_critical_sction(); //Here the context switch occurs
+			enter_critical_section();
+			stream->reader = MARIOS_INVALID_TASK_ID;
+		}
+		exit_critical_sction();
+	}
+
+	uint32_t tail = stream->tail;
+	uint32_t size = stream_distance(stream, tail, stream->head);
+	if(size > max_size)
+		size = max_size;
+	memory_barrier(); //The head is read before the bytes
+	uint32_t chunk = stream->size - tail;
+	if(chunk > size)
+		chunk = size;
+	memcpy(data, stream->buffer + tail, chunk);
+	memcpy(data + chunk, stream->buffer, size - chunk);
+	memory_barrier(); //The bytes are read before the tail frees them
+	tail += size;
+	stream->tail = (tail >= stream->size) ? tail - stream->size : tail;
+	return size;
+}
+
+void set_stream_trigger_level(mariOS_stream_buffer* stream, uint32_t trigger_level)
+{
+	stream->trigger_level = clamp_trigger_level(stream, trigger_level);
+}
+
+uint32_t get_stream_available(mariOS_stream_buffer* stream)
+{
+	return stream_distance(stream, stream->tail, stream->head);
+}
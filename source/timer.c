@@ -0,0 +1,220 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	timer.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS software timers. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "timer.h"
+#include "notification.h"
+
+#define WHEEL_SLOT(tick) ((tick) & (MARIOS_CONFIG_TIMER_WHEEL_SIZE - 1))
+
+#if (MARIOS_CONFIG_TIMER_WHEEL_SIZE & (MARIOS_CONFIG_TIMER_WHEEL_SIZE - 1)) != 0
+#error "MARIOS_CONFIG_TIMER_WHEEL_SIZE must be a power of 2"
+#endif
+
+extern volatile uint32_t mariOS_ticks;
+
+/**
+ * The timer wheel: each slot heads the list of the running timers that
+ * expire on ticks congruent to its index.
+ */
+static mariOS_timer* timer_wheel[MARIOS_CONFIG_TIMER_WHEEL_SIZE];
+
+/**
+ * The last tick whose expired timers have been serviced.
+ */
+static uint32_t serviced_ticks;
+
+/**
+ * The number of timers linked to the wheel.
+ */
+static uint32_t running_timers;
+
+#if MARIOS_CONFIG_TIMER_DAEMON
+static mariOS_task_id_t timer_daemon_id = MARIOS_INVALID_TASK_ID;
+static mariOS_stack_t timer_daemon_stack[MARIOS_CONFIG_TIMER_DAEMON_STACK] __attribute__ ((aligned (4)));
+#endif
+
+/**
+ * The following functions link and unlink a timer to the wheel. They must be
+ * invoked inside a critical section.
+ */
+static void link_timer(mariOS_timer* timer)
+{
+	mariOS_timer** slot = &timer_wheel[WHEEL_SLOT(timer->expiration)];
+	timer->prev = NULL;
+	timer->next = *slot;
+	if(NULL != *slot)
+		(*slot)->prev = timer;
+	*slot = timer;
+	timer->running = 1;
+	running_timers++;
+}
+
+static void unlink_timer(mariOS_timer* timer)
+{
+	if(NULL != timer->prev)
+		timer->prev->next = timer->next;
+	else
+		timer_wheel[WHEEL_SLOT(timer->expiration)] = timer->next;
+	if(NULL != timer->next)
+		timer->next->prev = timer->prev;
+	timer->next = NULL;
+	timer->prev = NULL;
+	timer->running = 0;
+	running_timers--;
+}
+
+/**
+ * The function runs the callbacks of the timers expiring at tick. Each timer
+ * is unlinked (and relinked, if periodic) inside a critical section, while
+ * its callback runs outside, so that callbacks can start and stop timers.
+ */
+static void service_slot(uint32_t tick)
+{
+	while(1)
+	{
+		mariOS_timer* timer;
+		enter_critical_section();
+		{
+			for(timer = timer_wheel[WHEEL_SLOT(tick)]; NULL != timer && timer->expiration != tick; timer = timer->next);
+			if(NULL != timer)
+			{
+				unlink_timer(timer);
+				if(MARIOS_TIMER_PERIODIC == timer->type)
+				{
+					timer->expiration += timer->period; //Rescheduled on its own timeline: no drift
+					link_timer(timer);
+				}
+			}
+		}
+		exit_critical_sction();
+		if(NULL == timer)
+			return;
+		timer->callback(timer->argument);
+	}
+}
+
+/**
+ * The function services every tick elapsed since the last serviced one.
+ */
+static void service_timers(void)
+{
+	while(serviced_ticks != mariOS_ticks)
+		service_slot(++serviced_ticks);
+}
+
+#if MARIOS_CONFIG_TIMER_DAEMON
+static void timer_daemon(void)
+{
+	while(1)
+	{
+		take_notification(MARIOS_NOTIFY_TAKE_CLEAR, MARIOS_WAIT_FOREVER, NULL);
+		service_timers();
+	}
+}
+#endif
+
+void initTimer(mariOS_timer* timer, mariOS_timer_callback_t callback, void const* argument, mariOS_timer_type_t type)
+{
+	timer->callback = callback;
+	timer->argument = argument;
+	timer->type = type;
+	timer->period = 0;
+	timer->expiration = 0;
+	timer->running = 0;
+	timer->next = NULL;
+	timer->prev = NULL;
+}
+
+mariOS_timer_op_status_t start_timer(mariOS_timer* timer, uint32_t period_ticks)
+{
+#if !MARIOS_CONFIG_TIMERS
+	(void)timer;
+	(void)period_ticks;
+	return MARIOS_TIMER_INVALID_OP; //Timers would never expire
+#else
+	if(0 == period_ticks)
+		return MARIOS_TIMER_INVALID_OP;
+	enter_critical_section();
+	{
+		if(timer->running)
+			unlink_timer(timer);
+		if(0 == running_timers) //Nothing expired since the wheel emptied: ticks before now need no service
+			serviced_ticks = mariOS_ticks;
+		timer->period = period_ticks;
+		timer->expiration = mariOS_ticks + period_ticks;
+		link_timer(timer);
+	}
+	exit_critical_sction();
+	return MARIOS_TIMER_SUCCESS_OP;
+#endif
+}
+
+mariOS_timer_op_status_t stop_timer(mariOS_timer* timer)
+{
+	mariOS_timer_op_status_t status = MARIOS_TIMER_SUCCESS_OP;
+	enter_critical_section();
+	{
+		if(timer->running)
+			unlink_timer(timer);
+		else
+			status = MARIOS_TIMER_STOPPED_OP;
+	}
+	exit_critical_sction();
+	return status;
+}
+
+uint8_t is_timer_running(mariOS_timer* timer)
+{
+	return timer->running;
+}
+
+void mariOS_timer_init(void)
+{
+	memset(timer_wheel, 0, sizeof(timer_wheel));
+	serviced_ticks = mariOS_ticks;
+	running_timers = 0;
+#if MARIOS_CONFIG_TIMER_DAEMON
+	timer_daemon_id = mariOS_task_init(timer_daemon, timer_daemon_stack, MARIOS_CONFIG_TIMER_DAEMON_STACK,
+									   MARIOS_CONFIG_TIMER_DAEMON_PRIORITY, 0);
+#endif
+}
+
+void mariOS_timer_tick(void)
+{
+#if MARIOS_CONFIG_TIMER_DAEMON
+	//The daemon is woken up only if some timer may expire; the systick handler calls the scheduler
+	if(NULL != timer_wheel[WHEEL_SLOT(mariOS_ticks)] && MARIOS_INVALID_TASK_ID != timer_daemon_id)
+		notify_task_from_isr(timer_daemon_id, 0, MARIOS_NOTIFY_INCREMENT, NULL);
+#else
+	service_timers();
+#endif
+}
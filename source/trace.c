@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	trace.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of the mariOS kernel trace. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "trace.h"
+
+#if MARIOS_CONFIG_TRACE
+
+#include "mariOS.h"
+
+#if (MARIOS_CONFIG_TRACE_EVENTS & (MARIOS_CONFIG_TRACE_EVENTS - 1)) != 0
+#error "MARIOS_CONFIG_TRACE_EVENTS must be a power of 2"
+#endif
+
+mariOS_trace mariOS_trace_buffer;
+
+void mariOS_trace_record(uint8_t type, uint8_t task, uint16_t data)
+{
+	uint32_t index;
+	if(!mariOS_trace_buffer.enabled)
+		return;
+	do
+	{
+		index = load_exclusive(&mariOS_trace_buffer.index);
+	} while(0 != store_exclusive(&mariOS_trace_buffer.index, index+1));
+	mariOS_trace_event* event = &mariOS_trace_buffer.events[index & (MARIOS_CONFIG_TRACE_EVENTS - 1)];
+	event->timestamp = read_cycle_counter();
+	event->type = type;
+	event->task = task;
+	event->data = data;
+}
+
+void mariOS_trace_context_switch(void)
+{
+	mariOS_trace_record(MARIOS_TRACE_SWITCH, get_current_task_id(), 0);
+}
+
+void mariOS_trace_isr_enter(void)
+{
+	mariOS_trace_record(MARIOS_TRACE_ISR_ENTER, get_current_task_id(), get_active_exception());
+}
+
+void mariOS_trace_isr_exit(void)
+{
+	mariOS_trace_record(MARIOS_TRACE_ISR_EXIT, get_current_task_id(), get_active_exception());
+}
+
+void mariOS_trace_init(uint32_t cycles_per_tick)
+{
+	mariOS_trace_buffer.magic = MARIOS_TRACE_MAGIC;
+	mariOS_trace_buffer.size = MARIOS_CONFIG_TRACE_EVENTS;
+	mariOS_trace_buffer.cycles_per_tick = cycles_per_tick;
+	mariOS_trace_buffer.index = 0;
+	mariOS_trace_buffer.enabled = 1;
+}
+
+void mariOS_trace_stop(void)
+{
+	mariOS_trace_buffer.enabled = 0;
+}
+
+void mariOS_trace_start(void)
+{
+	mariOS_trace_buffer.enabled = 1;
+}
+
+#endif /* MARIOS_CONFIG_TRACE */
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	work_queue.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Implementation file of mariOS work queues. It just contains
+ * 			implementation of function declared in the corresponding header file
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include "work_queue.h"
+#include "notification.h"
+
+/**
+ * The work queue served by each task, since the task handler has no argument.
+ */
+static mariOS_work_queue* work_queue_of_task[MARIOS_CONFIG_MAX_TASKS];
+
+/**
+ * The function appends a pending item to the queue. It must be invoked inside
+ * a critical section and it returns 0 if the item was already pending.
+ */
+static uint8_t append_work(mariOS_work_queue* work_queue, mariOS_work_item* item)
+{
+	if(item->pending)
+		return 0;
+	item->pending = 1;
+	item->submit_cycles = read_cycle_counter();
+	item->next = NULL;
+	if(NULL == work_queue->tail)
+		work_queue->head = item;
+	else
+		work_queue->tail->next = item;
+	work_queue->tail = item;
+	return 1;
+}
+
+/**
+ * The function removes the first item of the queue, updating the latency
+ * statistics. It returns NULL if the queue is empty.
+ */
+static mariOS_work_item* next_work(mariOS_work_queue* work_queue)
+{
+	mariOS_work_item* item;
+	enter_critical_section();
+	{
+		item = work_queue->head;
+		if(NULL != item)
+		{
+			work_queue->head = item->next;
+			if(NULL == work_queue->head)
+				work_queue->tail = NULL;
+			item->pending = 0; //From now on, the item can be submitted again
+			work_queue->last_latency = read_cycle_counter() - item->submit_cycles;
+			if(work_queue->last_latency > work_queue->max_latency)
+				work_queue->max_latency = work_queue->last_latency;
+		}
+	}
+	exit_critical_sction();
+	return item;
+}
+
+static void work_queue_task(void)
+{
+	mariOS_work_queue* work_queue = work_queue_of_task[get_current_task_id()];
+	while(1)
+	{
+		take_notification(MARIOS_NOTIFY_TAKE_CLEAR, MARIOS_WAIT_FOREVER, NULL);
+		mariOS_work_item* item;
+		while(NULL != (item = next_work(work_queue)))
+			item->handler(item->context);
+	}
+}
+
+mariOS_work_op_status_t initWorkQueue(mariOS_work_queue* work_queue, mariOS_priority priority, mariOS_stack_t* stack_ptr, uint32_t stack_size)
+{
+	work_queue->head = NULL;
+	work_queue->tail = NULL;
+	work_queue->last_latency = 0;
+	work_queue->max_latency = 0;
+	work_queue->task = mariOS_task_init(work_queue_task, stack_ptr, stack_size, priority, 0);
+	if(MARIOS_INVALID_TASK_ID == work_queue->task)
+		return MARIOS_WORK_NO_TASK_OP;
+	work_queue_of_task[work_queue->task] = work_queue;
+	return MARIOS_WORK_SUCCESS_OP;
+}
+
+void initWorkItem(mariOS_work_item* item, mariOS_work_handler_t handler, void* context)
+{
+	item->handler = handler;
+	item->context = context;
+	item->pending = 0;
+	item->submit_cycles = 0;
+	item->next = NULL;
+}
+
+mariOS_work_op_status_t submit_work(mariOS_work_queue* work_queue, mariOS_work_item* item)
+{
+	uint8_t appended;
+	enter_critical_section();
+	{
+		appended = append_work(work_queue, item);
+	}
+	exit_critical_sction();
+	if(!appended)
+		return MARIOS_WORK_PENDING_OP;
+	notify_task(work_queue->task, 0, MARIOS_NOTIFY_INCREMENT);
+	return MARIOS_WORK_SUCCESS_OP;
+}
+
+mariOS_work_op_status_t submit_work_from_isr(mariOS_work_queue* work_queue, mariOS_work_item* item, uint8_t* higher_priority_task_woken)
+{
+	uint8_t appended;
+	enter_critical_section(); //The ISR can be preempted by another one with higher priority
+	{
+		appended = append_work(work_queue, item);
+	}
+	exit_critical_sction();
+	if(!appended)
+		return MARIOS_WORK_PENDING_OP;
+	notify_task_from_isr(work_queue->task, 0, MARIOS_NOTIFY_INCREMENT, higher_priority_task_woken);
+	return MARIOS_WORK_SUCCESS_OP;
+}
+
+uint32_t get_work_queue_last_latency(mariOS_work_queue* work_queue)
+{
+	return work_queue->last_latency;
+}
+
+uint32_t get_work_queue_max_latency(mariOS_work_queue* work_queue)
+{
+	return work_queue->max_latency;
+}
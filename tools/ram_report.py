@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Report of the RAM taken by the mariOS kernel.
+
+The report is built from the compiler rather than by hand: each kernel object
+is given a dummy array as large as its control block, and the symbol sizes
+are read back from the object files. It lists:
+  * the bytes of each kernel object, and how many of them fit into 1 KiB;
+  * the static RAM (.data and .bss) of each kernel module.
+
+Sizes follow the configuration and the target, hence the report must be built
+with the same compiler and flags of the application, e.g.:
+
+    ram_report.py --cflags "-mcpu=cortex-m4 -mthumb -Os -DSTM32F405xx -Iconfig -I$CUBE/Drivers/CMSIS/Include \\
+                            -I$CUBE/Drivers/CMSIS/Device/ST/STM32F4xx/Include"
+
+where the directory holding mariOS_config.h must be listed. The include
+directory of mariOS is added by the script. Modules that do not compile with
+the given flags are reported and skipped.
+"""
+
+import argparse
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Label, type and header of each kernel object
+OBJECTS = [
+    ("task control block", "mariOS_task_control_block_t", "mariOS.h"),
+    ("task statistics", "mariOS_task_statistics_block_t", "mariOS.h"),
+    ("task set", "mariOS_task_set", "mariOS.h"),
+    ("wait list", "mariOS_wait_list", "mariOS.h"),
+    ("queue", "mariOS_queue", "queue.h"),
+    ("queue set", "mariOS_queue_set", "queue.h"),
+    ("stream buffer", "mariOS_stream_buffer", "stream_buffer.h"),
+    ("mutex", "mariOS_mutex", "mutex.h"),
+    ("semaphore", "mariOS_semaphore", "semaphore.h"),
+    ("memory pool", "mariOS_pool", "pool.h"),
+    ("mail queue", "mariOS_mail_queue", "mail.h"),
+    ("heap", "mariOS_heap", "heap.h"),
+    ("timer", "mariOS_timer", "timer.h"),
+    ("work queue", "mariOS_work_queue", "work_queue.h"),
+    ("work item", "mariOS_work_item", "work_queue.h"),
+    ("srp job", "mariOS_job", "srp.h"),
+    ("srp resource", "mariOS_srp_resource", "srp.h"),
+]
+
+RAM_TYPES = "bBdDcC"
+
+
+def tool(cc, name):
+    """Returns the binutils tool of the toolchain of the compiler."""
+    prefix = re.sub(r"(gcc|clang|cc)(-[0-9.]+)?$", "", os.path.basename(cc))
+    return os.path.join(os.path.dirname(cc), prefix + name)
+
+
+def compile_object(cc, cflags, source, output):
+    command = [cc] + cflags + ["-I" + os.path.join(ROOT, "include"), "-fno-common", "-c", source, "-o", output]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    return result.returncode == 0, result.stdout
+
+
+def ram_symbols(nm, path):
+    """Returns the RAM symbols of an object file, as a name to size map."""
+    output = subprocess.run([nm, "-S", "-t", "d", "--defined-only", path], stdout=subprocess.PIPE,
+                            universal_newlines=True, check=True).stdout
+    symbols = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in RAM_TYPES:
+            symbols[fields[3]] = int(fields[1])
+    return symbols
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--cc", default="arm-none-eabi-gcc", help="compiler (default arm-none-eabi-gcc)")
+    parser.add_argument("--cflags", default="-mcpu=cortex-m4 -mthumb -Os", help="compiler flags")
+    args = parser.parse_args()
+    cflags = shlex.split(args.cflags)
+    nm = tool(args.cc, "nm")
+
+    with tempfile.TemporaryDirectory() as directory:
+        probe = os.path.join(directory, "ram_report.c")
+        with open(probe, "w") as source:
+            for header in sorted(set(header for _, _, header in OBJECTS)):
+                source.write('#include "%s"\n' % header)
+            for index, (_, type_name, _) in enumerate(OBJECTS):
+                source.write("char ram_report_%d[sizeof(%s)];\n" % (index, type_name))
+        ok, messages = compile_object(args.cc, cflags, probe, probe + ".o")
+        if not ok:
+            sys.exit("cannot compile the kernel headers:\n" + messages)
+        sizes = ram_symbols(nm, probe + ".o")
+
+        print("%-24s %8s %8s" % ("kernel object", "bytes", "per KiB"))
+        for index, (label, _, _) in enumerate(OBJECTS):
+            size = sizes["ram_report_%d" % index]
+            print("%-24s %8d %8d" % (label, size, 1024 // size if size else 0))
+
+        print()
+        print("%-24s %8s" % ("kernel module", "bytes"))
+        total = 0
+        source_dir = os.path.join(ROOT, "source")
+        for name in sorted(os.listdir(source_dir)):
+            if not name.endswith(".c"):
+                continue
+            output = os.path.join(directory, name + ".o")
+            ok, _ = compile_object(args.cc, cflags, os.path.join(source_dir, name), output)
+            if not ok:
+                print("%-24s %8s" % (name, "skipped"))
+                continue
+            size = sum(ram_symbols(nm, output).values())
+            total += size
+            print("%-24s %8d" % (name, size))
+        print("%-24s %8d" % ("total", total))
+
+
+if __name__ == "__main__":
+    main()
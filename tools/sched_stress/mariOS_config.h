@@ -0,0 +1,60 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	mariOS_config.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Configuration of the kernel built by the scheduler stress
+ * 			harness: the one of the target, with a 1 ms tick and the
+ * 			scheduler chosen at run time
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef STRESS_MARIOS_CONFIG_H_
+#define STRESS_MARIOS_CONFIG_H_
+
+#include "../../include/marios_config.h"
+
+#undef MARIOS_CONFIG_MAX_TASKS
+#define MARIOS_CONFIG_MAX_TASKS			32
+
+/* A tick every 100000 cycles of a virtual 100 MHz processor, namely every millisecond */
+#undef MARIOS_CONFIG_SYSTICK_FREQ
+#define MARIOS_CONFIG_SYSTICK_FREQ		100000
+#undef MARIOS_CONFIG_SYSTICK_FREQ_DIV
+#define MARIOS_CONFIG_SYSTICK_FREQ_DIV	1000
+
+/* The harness times and dispatches the policy under test */
+#undef MARIOS_SCHEDULER_FUNCTION
+#define MARIOS_SCHEDULER_FUNCTION		stress_scheduler
+void stress_scheduler(void);
+
+#undef MARIOS_CONFIG_TIMERS
+#define MARIOS_CONFIG_TIMERS				0
+#undef MARIOS_CONFIG_TRACE
+#define MARIOS_CONFIG_TRACE					0
+#undef MARIOS_CONFIG_TASK_HISTOGRAMS
+#define MARIOS_CONFIG_TASK_HISTOGRAMS		0
+
+#endif /* STRESS_MARIOS_CONFIG_H_ */
@@ -0,0 +1,26 @@
+# Comparison curves of the scheduler stress harness.
+# usage: gnuplot -e "data='stress.csv'" plot.gp  ->  stress.png
+if (!exists("data")) data = 'stress.csv'
+set datafile separator ','
+set terminal pngcairo size 1200,900
+set output 'stress.png'
+set multiplot layout 2,2
+set key left top
+set xlabel 'utilization'
+set grid
+
+set title 'deadline miss ratio'
+plot for [policy in "priority round_robin"] '< grep ^'.policy.', '.data using 2:3 with linespoints title policy
+
+set title 'max response time / period'
+set logscale y
+plot for [policy in "priority round_robin"] '< grep ^'.policy.', '.data using 2:4 with linespoints title policy
+unset logscale y
+
+set title 'context switches per second'
+plot for [policy in "priority round_robin"] '< grep ^'.policy.', '.data using 2:5 with linespoints title policy
+
+set title 'scheduler overhead (host ns per call)'
+plot for [policy in "priority round_robin"] '< grep ^'.policy.', '.data using 2:6 with linespoints title policy
+
+unset multiplot
@@ -0,0 +1,264 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	port_host.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Host implementation of the port layer for the scheduler
+ * 			stress harness. Tasks run on ucontext stacks of a virtual
+ * 			processor whose time only advances when tasks execute
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+#include "mariOS.h"
+#include "stress.h"
+
+/**
+ * Host stack of each task: task code runs on it, while the kernel only
+ * paints the stack it is given.
+ */
+#define STRESS_CONTEXT_STACK	(64*1024)
+
+extern mariOS_task_control_block_t* volatile mariOS_curr_task;
+extern mariOS_task_control_block_t* volatile mariOS_next_task;
+void marios_systick_handler(void);
+
+static ucontext_t stress_main_context;
+static ucontext_t stress_contexts[MARIOS_CONFIG_MAX_TASKS];
+static uint8_t* stress_stacks[MARIOS_CONFIG_MAX_TASKS];
+static int stress_contexts_size;
+
+static uint64_t stress_cycles;				/* virtual time */
+static uint32_t stress_cycles_per_tick;
+static uint32_t stress_horizon;				/* ticks of the run */
+static uint64_t stress_switches;
+
+static volatile uint8_t stress_primask;		/* interrupts are masked */
+static volatile uint8_t stress_isr;			/* the tick handler is running */
+static volatile uint8_t stress_pending;		/* a context switch is pending, as PendSV would be */
+
+/**
+ * The stack pointer of a task control block holds the index, plus one, of
+ * the context of the task.
+ */
+#define STRESS_CONTEXT(task)	(&stress_contexts[(task)->sp - 1])
+
+/**
+ * The function performs the pending context switch, as PendSV_Handler()
+ * does once no other exception is active.
+ */
+static void stress_switch(void)
+{
+	stress_pending = 0;
+	if(mariOS_next_task == mariOS_curr_task)
+		return;
+	mariOS_task_control_block_t* previous = mariOS_curr_task;
+	mariOS_curr_task = mariOS_next_task;
+	stress_switches++;
+	swapcontext(STRESS_CONTEXT(previous), STRESS_CONTEXT(mariOS_curr_task));
+}
+
+/**
+ * The function runs the system tick handler, then the pending context switch.
+ * Once the horizon is reached, it goes back to the caller of loadFirstTask().
+ */
+static void stress_tick(void)
+{
+	if(stress_cycles/stress_cycles_per_tick >= stress_horizon)
+		swapcontext(STRESS_CONTEXT(mariOS_curr_task), &stress_main_context);
+	stress_isr = 1;
+	marios_systick_handler();
+	stress_isr = 0;
+	if(stress_pending && !stress_primask)
+		stress_switch();
+}
+
+void stress_port_reset(uint32_t horizon_ticks)
+{
+	stress_contexts_size = 0;
+	stress_cycles = 0;
+	stress_cycles_per_tick = MARIOS_CONFIG_SYSTICK_FREQ;
+	stress_horizon = horizon_ticks;
+	stress_switches = 0;
+	stress_primask = 0;
+	stress_isr = 0;
+	stress_pending = 0;
+}
+
+void stress_execute(uint64_t cycles)
+{
+	while(cycles > 0)
+	{
+		uint64_t next_tick = (stress_cycles/stress_cycles_per_tick + 1)*stress_cycles_per_tick;
+		uint64_t step = (cycles < next_tick - stress_cycles) ? cycles : next_tick - stress_cycles;
+		stress_cycles += step;
+		cycles -= step;
+		if(stress_cycles == next_tick)
+			stress_tick();
+	}
+}
+
+uint64_t stress_now(void)
+{
+	return stress_cycles;
+}
+
+uint64_t stress_context_switches(void)
+{
+	return stress_switches;
+}
+
+void __disable_irq(void)
+{
+	stress_primask = 1;
+}
+
+/**
+ * Only the idle task masks interrupts directly: once they are enabled
+ * again, nothing happens until the next tick.
+ */
+void __enable_irq(void)
+{
+	exit_critical_sction();
+	if(mariOS_curr_task == mariOS_next_task && 0 == get_current_task_id())
+		stress_execute(stress_cycles_per_tick - stress_cycles%stress_cycles_per_tick);
+}
+
+void loadFirstTask()
+{
+	swapcontext(&stress_main_context, STRESS_CONTEXT(mariOS_curr_task));
+}
+
+uint32_t* initialize_Stack(uint32_t* stack_ptr, void (*task_handler)(void), void (*task_completion)(void))
+{
+	(void)stack_ptr;
+	(void)task_completion;
+	int index = stress_contexts_size++;
+	if(NULL == stress_stacks[index] && NULL == (stress_stacks[index] = malloc(STRESS_CONTEXT_STACK)))
+	{
+		perror("stress");
+		exit(EXIT_FAILURE);
+	}
+	getcontext(&stress_contexts[index]);
+	stress_contexts[index].uc_stack.ss_sp = stress_stacks[index];
+	stress_contexts[index].uc_stack.ss_size = STRESS_CONTEXT_STACK;
+	stress_contexts[index].uc_link = NULL;
+	makecontext(&stress_contexts[index], task_handler, 0);
+	return (uint32_t*)(uintptr_t)(index + 1);
+}
+
+void yield()
+{
+	stress_pending = 1;
+	if(!stress_primask && !stress_isr)
+		stress_switch();
+}
+
+void enter_critical_section()
+{
+	stress_primask = 1;
+}
+
+void exit_critical_sction()
+{
+	stress_primask = 0;
+	if(stress_pending && !stress_isr)
+		stress_switch();
+}
+
+uint32_t load_exclusive(volatile uint32_t* address)
+{
+	return *address;
+}
+
+uint32_t store_exclusive(volatile uint32_t* address, uint32_t value)
+{
+	*address = value; //Tasks are never preempted between the load and the store
+	return 0;
+}
+
+void clear_exclusive()
+{
+}
+
+void memory_barrier()
+{
+}
+
+void init_cycle_counter()
+{
+}
+
+uint32_t read_cycle_counter()
+{
+	return (uint32_t)stress_cycles;
+}
+
+uint32_t read_systick_elapsed(uint8_t* tick_pending)
+{
+	*tick_pending = 0; //Ticks are serviced as soon as they elapse
+	return (uint32_t)(stress_cycles % stress_cycles_per_tick);
+}
+
+uint32_t get_active_exception()
+{
+	return stress_isr ? 15 : 0;
+}
+
+uint8_t is_isr_context()
+{
+	return stress_isr;
+}
+
+void configure_job_interrupt(int32_t irq_number, uint8_t level)
+{
+	(void)irq_number;
+	(void)level;
+}
+
+void pend_job_interrupt(int32_t irq_number)
+{
+	(void)irq_number;
+}
+
+uint32_t raise_preemption_threshold(uint8_t level)
+{
+	(void)level;
+	return 0;
+}
+
+void restore_preemption_threshold(uint32_t threshold)
+{
+	(void)threshold;
+}
+
+int configureSystick(uint32_t systick_ticks)
+{
+	stress_cycles_per_tick = systick_ticks;
+	return 0;
+}
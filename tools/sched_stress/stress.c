@@ -0,0 +1,311 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	stress.c
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Scheduler stress harness. It generates random periodic task
+ * 			sets by means of UUniFast, runs them on the kernel in virtual
+ * 			time for each scheduling policy and prints a CSV comparison
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "mariOS.h"
+#include "stress.h"
+
+#define STRESS_MAX_TASKS		(MARIOS_CONFIG_MAX_TASKS-2)	/* the idle task takes a slot */
+#define STRESS_MIN_PERIOD		10		/* ticks */
+#define STRESS_MAX_PERIOD		1000	/* ticks */
+
+void round_robin_scheduler();
+void priority_scheduler();
+
+/**
+ * Scheduling policies under comparison.
+ */
+static const struct
+{
+	const char* name;
+	void (*function)(void);
+} stress_policies[] =
+{
+	{ "priority", priority_scheduler },
+	{ "round_robin", round_robin_scheduler },
+};
+
+#define STRESS_POLICIES			(sizeof(stress_policies)/sizeof(stress_policies[0]))
+
+/**
+ * A periodic task of the generated set.
+ */
+typedef struct
+{
+	uint32_t period;				/* ticks, which are milliseconds */
+	uint64_t wcet;					/* cycles executed by each job */
+	mariOS_priority priority;		/* rate monotonic */
+	mariOS_task_id_t id;
+	uint64_t max_response;			/* cycles */
+	uint64_t on_time_jobs;			/* jobs whose response did not exceed the period */
+} stress_task_t;
+
+/**
+ * Outcome of the runs of a policy at a given utilization.
+ */
+typedef struct
+{
+	uint64_t released_jobs;			/* jobs whose deadline is within the horizon */
+	uint64_t missed_jobs;			/* those not completed by their deadline */
+	double max_response_ratio;		/* worst response time over the period of the task */
+	uint64_t context_switches;
+	uint64_t scheduler_calls;
+	uint64_t scheduler_ns;			/* host time spent into the policy */
+} stress_result_t;
+
+static stress_task_t stress_tasks[STRESS_MAX_TASKS];
+static stress_task_t* stress_task_of[MARIOS_CONFIG_MAX_TASKS];
+static mariOS_stack_t stress_task_stacks[STRESS_MAX_TASKS][MARIOS_MINIMUM_TASK_STACK_SIZE];
+static int stress_tasks_size;
+
+static void (*stress_policy)(void);
+static uint64_t stress_scheduler_calls;
+static uint64_t stress_scheduler_ns;
+static uint64_t stress_clock_overhead;
+
+static uint64_t stress_seed = 1;
+
+/**
+ * xorshift64*, so that task sets only depend on the seed.
+ */
+static double stress_random(void)
+{
+	stress_seed ^= stress_seed >> 12;
+	stress_seed ^= stress_seed << 25;
+	stress_seed ^= stress_seed >> 27;
+	return (double)((stress_seed * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+}
+
+static uint64_t stress_host_ns(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec*1000000000 + now.tv_nsec;
+}
+
+void stress_scheduler(void)
+{
+	uint64_t start = stress_host_ns();
+	stress_policy();
+	uint64_t elapsed = stress_host_ns() - start;
+	stress_scheduler_ns += (elapsed > stress_clock_overhead) ? elapsed - stress_clock_overhead : 0;
+	stress_scheduler_calls++;
+}
+
+/**
+ * The body of every task: each job executes its WCET and records its
+ * response time, from its release to its completion.
+ */
+static void stress_job(void)
+{
+	stress_task_t* task = stress_task_of[get_current_task_id()];
+	mariOS_task_control_block_t* control_block = get_task_control_block(get_current_task_id());
+	mariOS_begin_periodic
+	{
+		stress_execute(task->wcet);
+		uint64_t response = stress_now() - (uint64_t)control_block->release_tick*MARIOS_CONFIG_SYSTICK_FREQ;
+		if(response > task->max_response)
+			task->max_response = response;
+		if(response <= (uint64_t)task->period*MARIOS_CONFIG_SYSTICK_FREQ) //Measured in cycles, as the response ratio
+			task->on_time_jobs++;
+	}
+	mariOS_end_periodic;
+}
+
+static int stress_by_period(const void* a, const void* b)
+{
+	const stress_task_t* first = a;
+	const stress_task_t* second = b;
+	return (first->period > second->period) - (first->period < second->period);
+}
+
+/**
+ * The function generates a task set of the given utilization by means of
+ * UUniFast, discarding sets with a task utilization above 1. Periods are
+ * log-uniform and priorities are rate monotonic.
+ */
+static void stress_generate(int tasks, double utilization)
+{
+	int i;
+	double utilizations[STRESS_MAX_TASKS];
+	int valid;
+	do
+	{
+		double sum = utilization;
+		valid = 1;
+		for(i = 0; i < tasks-1; i++)
+		{
+			double next = sum*pow(stress_random(), 1.0/(tasks-1-i));
+			utilizations[i] = sum - next;
+			sum = next;
+		}
+		utilizations[tasks-1] = sum;
+		for(i = 0; i < tasks; i++)
+			if(utilizations[i] > 1.0)
+				valid = 0;
+	} while(!valid);
+
+	for(i = 0; i < tasks; i++)
+	{
+		double period = exp(log(STRESS_MIN_PERIOD) + stress_random()*(log(STRESS_MAX_PERIOD)-log(STRESS_MIN_PERIOD)));
+		stress_tasks[i].period = (uint32_t)period;
+		stress_tasks[i].wcet = (uint64_t)(utilizations[i]*stress_tasks[i].period*MARIOS_CONFIG_SYSTICK_FREQ);
+		if(0 == stress_tasks[i].wcet)
+			stress_tasks[i].wcet = 1;
+	}
+	qsort(stress_tasks, tasks, sizeof(stress_tasks[0]), stress_by_period);
+	for(i = 0; i < tasks; i++)
+		stress_tasks[i].priority = tasks - i;
+	stress_tasks_size = tasks;
+}
+
+/**
+ * The function runs the current task set with a policy and accumulates
+ * the outcome.
+ */
+static void stress_run(void (*policy)(void), uint32_t horizon, stress_result_t* result)
+{
+	int i;
+	stress_policy = policy;
+	stress_scheduler_calls = 0;
+	stress_scheduler_ns = 0;
+	stress_port_reset(horizon);
+	mariOS_init();
+	for(i = 0; i < stress_tasks_size; i++)
+	{
+		stress_tasks[i].max_response = 0;
+		stress_tasks[i].on_time_jobs = 0;
+		stress_tasks[i].id = mariOS_task_init(stress_job, stress_task_stacks[i], MARIOS_MINIMUM_TASK_STACK_SIZE,
+											  stress_tasks[i].priority, stress_tasks[i].period);
+		stress_task_of[stress_tasks[i].id] = &stress_tasks[i];
+	}
+	mariOS_start(MARIOS_CONFIG_SYSTICK_FREQ);
+
+	for(i = 0; i < stress_tasks_size; i++)
+	{
+		stress_task_t* task = &stress_tasks[i];
+		uint64_t released = horizon/task->period;
+		result->released_jobs += released;
+		result->missed_jobs += (task->on_time_jobs < released) ? released - task->on_time_jobs : 0;
+		double ratio = (double)task->max_response/((uint64_t)task->period*MARIOS_CONFIG_SYSTICK_FREQ);
+		if(ratio > result->max_response_ratio)
+			result->max_response_ratio = ratio;
+	}
+	result->context_switches += stress_context_switches();
+	result->scheduler_calls += stress_scheduler_calls;
+	result->scheduler_ns += stress_scheduler_ns;
+}
+
+static void stress_calibrate_clock(void)
+{
+	int i;
+	stress_clock_overhead = (uint64_t)-1;
+	for(i = 0; i < 1000; i++)
+	{
+		uint64_t start = stress_host_ns();
+		uint64_t elapsed = stress_host_ns() - start;
+		if(elapsed < stress_clock_overhead)
+			stress_clock_overhead = elapsed;
+	}
+}
+
+static void stress_usage(const char* name)
+{
+	fprintf(stderr, "usage: %s [-n tasks] [-s sets] [-t ticks] [-u min,max,step] [-r seed]\n"
+					"  -n tasks per set (default 8, at most %d)\n"
+					"  -s task sets per utilization (default 20)\n"
+					"  -t ticks of each run, a tick is 1 ms (default 100000)\n"
+					"  -u utilization range (default 0.5,1.0,0.05)\n"
+					"  -r seed of the generator (default 1)\n", name, STRESS_MAX_TASKS);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[])
+{
+	int tasks = 8, sets = 20, i, set;
+	uint32_t horizon = 100000;
+	double min_utilization = 0.5, max_utilization = 1.0, step = 0.05, utilization;
+	size_t p;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(i+1 >= argc)
+			stress_usage(argv[0]);
+		if(!strcmp(argv[i], "-n"))
+			tasks = atoi(argv[++i]);
+		else if(!strcmp(argv[i], "-s"))
+			sets = atoi(argv[++i]);
+		else if(!strcmp(argv[i], "-t"))
+			horizon = strtoul(argv[++i], NULL, 0);
+		else if(!strcmp(argv[i], "-u"))
+		{
+			if(3 != sscanf(argv[++i], "%lf,%lf,%lf", &min_utilization, &max_utilization, &step))
+				stress_usage(argv[0]);
+		}
+		else if(!strcmp(argv[i], "-r"))
+			stress_seed = strtoull(argv[++i], NULL, 0);
+		else
+			stress_usage(argv[0]);
+	}
+	if(tasks < 1 || tasks > STRESS_MAX_TASKS || sets < 1 || 0 == horizon || step <= 0 || 0 == stress_seed)
+		stress_usage(argv[0]);
+
+	stress_calibrate_clock();
+	printf("scheduler,utilization,miss_ratio,max_response_ratio,switches_per_second,scheduler_ns\n");
+	for(utilization = min_utilization; utilization <= max_utilization + step/2; utilization += step)
+	{
+		stress_result_t results[STRESS_POLICIES];
+		memset(results, 0, sizeof(results));
+		for(set = 0; set < sets; set++)
+		{
+			stress_generate(tasks, utilization);
+			for(p = 0; p < STRESS_POLICIES; p++) //Every policy runs the same task set
+				stress_run(stress_policies[p].function, horizon, &results[p]);
+		}
+		for(p = 0; p < STRESS_POLICIES; p++)
+		{
+			stress_result_t* result = &results[p];
+			printf("%s,%.3f,%.6f,%.3f,%.1f,%.1f\n", stress_policies[p].name, utilization,
+				   (double)result->missed_jobs/result->released_jobs, result->max_response_ratio,
+				   (double)result->context_switches*1000/((double)horizon*sets),
+				   result->scheduler_calls ? (double)result->scheduler_ns/result->scheduler_calls : 0.0);
+		}
+		fflush(stdout);
+	}
+	return 0;
+}
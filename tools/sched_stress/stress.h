@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ *
+ * @file 	stress.h
+ * @author 	Mario Barbareschi <mario.barbareschi@unina.it>
+ * @version V1.0
+ * @date    19-October-2026
+ * @brief 	Virtual processor of the scheduler stress harness, on which
+ * 			the kernel runs in virtual time
+ *
+ ******************************************************************************
+ * @attention
+ *
+ *  Copyright (C) 2018  Mario Barbareschi
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as
+ *  published by the Free Software Foundation, either version 3 of the
+ *  License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************
+ */
+
+
+#ifndef STRESS_H_
+#define STRESS_H_
+
+#include <inttypes.h>
+
+/**
+ * @brief The function restores a pristine virtual processor. It must be
+ * called before mariOS_init(); mariOS_start() then returns once the given
+ * number of ticks elapses.
+ *
+ * @param [in] horizon_ticks is the duration of the run
+ * @retval None
+ */
+void stress_port_reset(uint32_t horizon_ticks);
+
+/**
+ * @brief The function consumes the given number of cycles on behalf of the
+ * current task. Ticks occur meanwhile, hence the task can be preempted.
+ *
+ * @param [in] cycles is the execution time to consume
+ * @retval None
+ */
+void stress_execute(uint64_t cycles);
+
+/**
+ * @brief The function returns the virtual time, in cycles since the reset.
+ *
+ * @param None
+ * @return the virtual time
+ */
+uint64_t stress_now(void);
+
+/**
+ * @brief The function returns the number of context switches performed since
+ * the reset.
+ *
+ * @param None
+ * @return the number of context switches
+ */
+uint64_t stress_context_switches(void);
+
+#endif /* STRESS_H_ */
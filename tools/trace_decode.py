@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Decoder of the mariOS kernel trace (see include/trace.h).
+
+The trace is dumped from the target as raw memory, e.g. with gdb:
+
+    dump binary memory trace.bin &mariOS_trace_buffer (&mariOS_trace_buffer)+1
+
+and converted into:
+  * a Chrome/Perfetto JSON trace (open it with https://ui.perfetto.dev), or
+  * a Common Trace Format directory (open it with Trace Compass or babeltrace).
+
+Usage:
+    trace_decode.py trace.bin --format perfetto -o trace.json
+    trace_decode.py trace.bin --format ctf -o trace_ctf/
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+MAGIC = 0x6D4F5354
+HEADER = struct.Struct("<5I")
+EVENT = struct.Struct("<IBBH")
+
+EVENT_NAMES = {
+    1: "schedule",
+    2: "switch",
+    3: "status",
+    4: "wakeup",
+    5: "queue_send",
+    6: "queue_receive",
+    7: "queue_block",
+    8: "isr_enter",
+    9: "isr_exit",
+    10: "tick",
+    11: "user",
+}
+
+# mariOS_task_status_t, as stored into the 16-bit data field (MARIOS_TASK_STATUS_WAIT is -1)
+STATUS_NAMES = {0: "ready", 1: "active", 2: "suspend", 0xFFFF: "wait"}
+
+
+def read_trace(path):
+    """Returns the header fields and the events in chronological order, with
+    timestamps unwrapped to 64 bits."""
+    with open(path, "rb") as dump:
+        data = dump.read()
+    offset = data.find(struct.pack("<I", MAGIC))
+    if offset < 0:
+        sys.exit("%s: no mariOS trace found" % path)
+    magic, size, cycles_per_tick, index, _ = HEADER.unpack_from(data, offset)
+    offset += HEADER.size
+    count = min(index, size)
+    first = index - count
+    events = []
+    for i in range(first, index):
+        events.append(EVENT.unpack_from(data, offset + (i % size) * EVENT.size))
+    unwrapped, base, last = [], 0, None
+    for timestamp, kind, task, value in events:
+        if last is not None and timestamp < last:
+            base += 1 << 32  # the cycle counter wrapped around
+        last = timestamp
+        unwrapped.append((base + timestamp, kind, task, value))
+    return cycles_per_tick, unwrapped
+
+
+def to_perfetto(events, cycles_per_us):
+    """Converts the events into Chrome trace events: a slice for each interval
+    a task holds the CPU, plus instant events."""
+    trace, running, since = [], None, None
+    for timestamp, kind, task, value in events:
+        us = timestamp / cycles_per_us
+        name = EVENT_NAMES.get(kind, "event%d" % kind)
+        if kind == 2:  # context switch
+            if running is not None:
+                trace.append({"name": "running", "ph": "X", "pid": 0, "tid": running,
+                              "ts": since, "dur": us - since})
+            running, since = task, us
+        elif kind in (8, 9):
+            trace.append({"name": "isr%d" % value, "ph": "B" if kind == 8 else "E",
+                          "pid": 1, "tid": value, "ts": us})
+        else:
+            args = {"data": value}
+            if kind == 3:
+                args = {"status": STATUS_NAMES.get(value, value)}
+            trace.append({"name": name, "ph": "i", "s": "t", "pid": 0, "tid": task,
+                          "ts": us, "args": args})
+    metadata = [{"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "tasks"}},
+                {"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "interrupts"}}]
+    return {"traceEvents": metadata + trace, "displayTimeUnit": "ns"}
+
+
+CTF_METADATA = """/* CTF 1.8 */
+typealias integer { size = 8; align = 8; signed = false; } := uint8_t;
+typealias integer { size = 16; align = 8; signed = false; } := uint16_t;
+typealias integer { size = 32; align = 8; signed = false; } := uint32_t;
+typealias integer { size = 64; align = 8; signed = false; } := uint64_t;
+
+trace {
+	major = 1;
+	minor = 8;
+	byte_order = le;
+	packet.header := struct { uint32_t magic; };
+};
+
+clock {
+	name = cycles;
+	freq = %d;
+};
+
+typealias integer { size = 64; align = 8; signed = false; map = clock.cycles.value; } := cycles_t;
+
+stream {
+	event.header := struct { cycles_t timestamp; uint8_t id; };
+};
+
+%s
+"""
+
+
+def to_ctf(events, cpu_hz, directory):
+    """Writes a CTF trace: the metadata describes one event class per kind of
+    event, each carrying the task and the data fields."""
+    os.makedirs(directory, exist_ok=True)
+    classes = "\n".join(
+        "event {\n\tname = %s;\n\tid = %d;\n\tfields := struct { uint8_t task; uint16_t data; };\n};\n"
+        % (name, kind) for kind, name in sorted(EVENT_NAMES.items()))
+    with open(os.path.join(directory, "metadata"), "w") as metadata:
+        metadata.write(CTF_METADATA % (cpu_hz, classes))
+    with open(os.path.join(directory, "stream"), "wb") as stream:
+        stream.write(struct.pack("<I", 0xC1FC1FC1))
+        for timestamp, kind, task, value in events:
+            stream.write(struct.pack("<QBBH", timestamp, kind, task, value))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump", help="binary dump of mariOS_trace_buffer")
+    parser.add_argument("--format", choices=("perfetto", "ctf"), default="perfetto")
+    parser.add_argument("--tick-hz", type=int, default=10000,
+                        help="systick frequency, i.e. MARIOS_CONFIG_SYSTICK_FREQ_DIV (default 10000)")
+    parser.add_argument("-o", "--output", required=True, help="output file (perfetto) or directory (ctf)")
+    args = parser.parse_args()
+
+    cycles_per_tick, events = read_trace(args.dump)
+    cpu_hz = cycles_per_tick * args.tick_hz
+    if args.format == "perfetto":
+        with open(args.output, "w") as output:
+            json.dump(to_perfetto(events, cpu_hz / 1e6), output)
+    else:
+        to_ctf(events, cpu_hz, args.output)
+    print("%d events decoded" % len(events))
+
+
+if __name__ == "__main__":
+    main()